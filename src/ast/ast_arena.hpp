@@ -3,18 +3,49 @@
 
 #include <vector>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 #include <utility>
 
+#include "./utility/chunk_pool.hpp"
+
+// ======================
+// -- ArenaSpan
+// ======================
+
+/// @brief Contiguous run of values owned by an ASTArena
+/// @tparam T Trivially copyable element type
+template <typename T>
+struct ArenaSpan
+{
+	T *data = nullptr;  // T*: First element, nullptr if empty
+	uint32_t count = 0; // uint32_t: # of elements
+
+	T *begin() const { return data; }
+	T *end() const { return data + count; }
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	T &operator[](size_t index) const { return data[index]; }
+};
+
 // ======================
 // -- ASTArena
 // ======================
 
+/// @brief Bump allocator for AST nodes
+/// @note Chunks grow geometrically up to a cap and come from ChunkPool, reset() / rewind() keep them for the next parse
 class ASTArena
 {
 	public:
-		std::vector<std::byte *> chunks;
-		size_t offset = 0;
-		static constexpr size_t CHUNK_SIZE = 65536;
+		static constexpr size_t DEFAULT_FIRST_CHUNK_SIZE = ChunkPool::MIN_CHUNK_SIZE;
+		static constexpr size_t DEFAULT_MAX_CHUNK_SIZE = size_t{1} << 20;
+
+		struct Chunk
+		{
+			std::byte *data; // std::byte*: Start of the chunk
+			size_t size;     // size_t: Size in bytes
+		};
 
 		struct ManagedObject
 		{
@@ -22,16 +53,76 @@ class ASTArena
 			void (*destructor)(void *);
 		};
 
-		std::vector<ManagedObject> managed_objects;
+		/// @brief Position to rewind to, see mark()
+		struct Marker
+		{
+			size_t chunk;      // size_t: Index of the current chunk
+			size_t offset;     // size_t: Offset into the current chunk
+			size_t bytes_used; // size_t: Bytes used at the mark
+			size_t managed;    // size_t: # of managed objects at the mark
+			size_t oversized;  // size_t: # of oversized blocks at the mark
+		};
 
-		/// @brief Allocate a new chunk based on CHUNK_SIZE
-		void allocate_new_chunk()
+		struct ArenaStats
 		{
-			chunks.push_back(new std::byte[CHUNK_SIZE]);
-			offset = 0;
-		}
+			size_t bytes_used;     // size_t: Bytes handed out since the last reset, including alignment padding
+			size_t bytes_reserved; // size_t: Bytes held in chunks and oversized blocks
+			size_t chunks;         // size_t: # of chunks held
+			size_t oversized;      // size_t: # of blocks larger than the chunk cap
+			size_t high_water;     // size_t: Most bytes_used seen over the arena's lifetime
+		};
+
+	private:
+		std::vector<Chunk> chunks;                   // std::vector: Chunks in allocation order, kept across resets
+		std::vector<Chunk> oversized;                // std::vector: Blocks larger than max_chunk_size, freed on reset
+		std::vector<ManagedObject> managed_objects;  // std::vector: Non-trivially destructible objects to destroy on reset
+		size_t current = 0;                          // size_t: Index of the chunk being bumped
+		size_t offset = 0;                           // size_t: Next free byte in the current chunk
+		size_t first_chunk_size;                     // size_t: Size of the first chunk
+		size_t max_chunk_size;                       // size_t: Cap for geometric growth
+		size_t bytes_used = 0;                       // size_t: See ArenaStats
+		mutable size_t high_water = 0;               // size_t: See ArenaStats
+
+		/// @brief Move to a chunk with room for a block, reusing retained chunks before growing
+		/// @param size: # of bytes needed, including alignment slack
+		void next_chunk(size_t size);
+
+		/// @brief Allocate a block larger than max_chunk_size on its own
+		/// @param size: # of bytes
+		/// @return Uninitialized memory
+		void *alloc_oversized(size_t size);
 
 	public:
+		/// @brief Bump allocate raw memory
+		/// @param size: # of bytes
+		/// @param alignment: Alignment, a power of two
+		/// @return Uninitialized memory valid until the arena is reset, rewound past it or destroyed
+		void *alloc_bytes(size_t size, size_t alignment)
+		{
+			if (size + alignment > max_chunk_size)
+				return alloc_oversized(size);
+
+			if (!chunks.empty())
+			{
+				size_t aligned = (offset + alignment - 1) & ~(alignment - 1);
+
+				if (aligned + size <= chunks[current].size) [[likely]]
+				{
+					bytes_used += aligned + size - offset;
+					offset = aligned + size;
+					return chunks[current].data + aligned;
+				}
+			}
+
+			next_chunk(size + alignment);
+
+			size_t aligned = (offset + alignment - 1) & ~(alignment - 1);
+			bytes_used += aligned + size - offset;
+			offset = aligned + size;
+
+			return chunks[current].data + aligned;
+		}
+
 		/// @brief Custom std::unique_ptr to avoid overhead
 		/// @tparam T Template
 		/// @tparam ...Args Template
@@ -40,25 +131,7 @@ class ASTArena
 		template <typename T, typename... Args>
 			T *alloc(Args &&...args)
 			{
-				constexpr size_t size = sizeof(T);
-				constexpr size_t alignment = alignof(T);
-
-				if (chunks.empty() || offset + size + alignment > CHUNK_SIZE)
-					allocate_new_chunk();
-
-				std::byte *base = chunks.back();
-				std::byte *aligned = base + ((offset + alignment - 1) & ~(alignment - 1));
-
-				if (aligned + size > base + CHUNK_SIZE)
-				{
-					allocate_new_chunk();
-					base = chunks.back();
-					aligned = base;
-				}
-
-				offset = (aligned - base) + size;
-
-				T *result = new (aligned) T(std::forward<Args>(args)...);
+				T *result = new (alloc_bytes(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
 
 				if constexpr (!std::is_trivially_destructible_v<T>)
 				{
@@ -69,26 +142,60 @@ class ASTArena
 				return result;
 			}
 
+		/// @brief Copy a run of values into the arena
+		/// @tparam T Trivially copyable element type
+		/// @param values: First value to copy
+		/// @param count: # of values
+		/// @return ArenaSpan over the copy, empty if count is 0
+		template <typename T>
+			ArenaSpan<T> copy_span(const T *values, size_t count)
+			{
+				static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+						"ArenaSpan elements are copied bytewise and never destroyed");
+
+				if (count == 0)
+					return {};
+
+				T *data = static_cast<T *>(alloc_bytes(sizeof(T) * count, alignof(T)));
+				std::memcpy(data, values, sizeof(T) * count);
+
+				return {data, static_cast<uint32_t>(count)};
+			}
+
 		// ======================
 		// -- CONSTRUCTOR
 		// ======================
 
-		/// @brief Default constructor
-		ASTArena() = default;
+		/// @brief Construct an empty arena, no memory is taken until the first allocation
+		/// @param first_chunk: Size of the first chunk, rounded up to a power of two
+		/// @param max_chunk: Cap for geometric chunk growth, larger blocks are allocated on their own
+		explicit ASTArena(size_t first_chunk = DEFAULT_FIRST_CHUNK_SIZE, size_t max_chunk = DEFAULT_MAX_CHUNK_SIZE);
 
 		// ======================
 		// -- DESTRUCTOR
 		// ======================
 
-		/// @brief Destructor for ASTArena
-		~ASTArena()
-		{
-			for (auto it = managed_objects.rbegin(); it != managed_objects.rend(); ++it)
-				it->destructor(it->ptr);
+		/// @brief Destroy managed objects and return every chunk to ChunkPool
+		~ASTArena();
 
-			for (auto *chunk : chunks)
-				delete[] chunk;
-		}
+		// ======================
+		// -- PUBLIC METHODS
+		// ======================
+
+		/// @brief Current position, pass it to rewind() to free everything allocated after it
+		/// @return Marker
+		Marker mark() const { return {current, offset, bytes_used, managed_objects.size(), oversized.size()}; }
+
+		/// @brief Free everything allocated after a mark, keeping the chunks
+		/// @param marker: Mark from this arena, later marks are invalidated
+		void rewind(const Marker &marker);
+
+		/// @brief Free everything, keeping the chunks for the next parse
+		void reset();
+
+		/// @brief Memory usage of the arena
+		/// @return ArenaStats
+		ArenaStats stats() const;
 
 		// ======================
 		// -- MISC
@@ -115,6 +222,8 @@ class ASTArena
 	template <typename T, typename... Args>
 T *make_node(ASTArena &arena, Args &&...args)
 {
+	static_assert(std::is_trivially_destructible_v<T>, "AST nodes are never destroyed, they must be trivially destructible");
+
 	return arena.alloc<T>(std::forward<Args>(args)...);
 }
 
@@ -0,0 +1,132 @@
+#include <algorithm>
+
+#include "./ast_arena.hpp"
+
+// ======================
+// -- INIT
+// ======================
+
+/// @brief Construct an empty arena, no memory is taken until the first allocation
+/// @param first_chunk: Size of the first chunk, rounded up to a power of two
+/// @param max_chunk: Cap for geometric chunk growth, larger blocks are allocated on their own
+ASTArena::ASTArena(size_t first_chunk, size_t max_chunk)
+{
+	first_chunk_size = ChunkPool::MIN_CHUNK_SIZE;
+
+	while (first_chunk_size < first_chunk && first_chunk_size < ChunkPool::MAX_CHUNK_SIZE)
+		first_chunk_size <<= 1;
+
+	max_chunk_size = first_chunk_size;
+
+	while (max_chunk_size < max_chunk && max_chunk_size < ChunkPool::MAX_CHUNK_SIZE)
+		max_chunk_size <<= 1;
+}
+
+/// @brief Destroy managed objects and return every chunk to ChunkPool
+ASTArena::~ASTArena()
+{
+	reset();
+
+	for (const Chunk &chunk : chunks)
+		ChunkPool::instance().release(chunk.data, chunk.size);
+}
+
+// ======================
+// -- CHUNK IMPL.
+// ======================
+
+/// @brief Move to a chunk with room for a block, reusing retained chunks before growing
+/// @param size: # of bytes needed, including alignment slack
+void ASTArena::next_chunk(size_t size)
+{
+	size_t next = chunks.empty() ? 0 : current + 1;
+
+	// Chunks past the current one are free, their order does not matter
+	for (size_t i = next; i < chunks.size(); i++)
+	{
+		if (chunks[i].size >= size)
+		{
+			std::swap(chunks[i], chunks[next]);
+			current = next;
+			offset = 0;
+			return;
+		}
+	}
+
+	size_t chunk_size = first_chunk_size;
+
+	for (const Chunk &chunk : chunks)
+		chunk_size = std::max(chunk_size, std::min(chunk.size * 2, max_chunk_size));
+
+	while (chunk_size < size)
+		chunk_size <<= 1;
+
+	chunks.push_back({ChunkPool::instance().acquire(chunk_size), chunk_size});
+	std::swap(chunks.back(), chunks[next]);
+
+	current = next;
+	offset = 0;
+}
+
+/// @brief Allocate a block larger than max_chunk_size on its own
+/// @param size: # of bytes
+/// @return Uninitialized memory
+void *ASTArena::alloc_oversized(size_t size)
+{
+	std::byte *block = new std::byte[size];
+	oversized.push_back({block, size});
+	bytes_used += size;
+
+	return block;
+}
+
+// ======================
+// -- PUBLIC METHODS
+// ======================
+
+/// @brief Free everything allocated after a mark, keeping the chunks
+/// @param marker: Mark from this arena, later marks are invalidated
+void ASTArena::rewind(const Marker &marker)
+{
+	high_water = std::max(high_water, bytes_used);
+
+	while (managed_objects.size() > marker.managed)
+	{
+		ManagedObject object = managed_objects.back();
+		managed_objects.pop_back();
+		object.destructor(object.ptr);
+	}
+
+	while (oversized.size() > marker.oversized)
+	{
+		delete[] oversized.back().data;
+		oversized.pop_back();
+	}
+
+	current = marker.chunk;
+	offset = marker.offset;
+	bytes_used = marker.bytes_used;
+}
+
+/// @brief Free everything, keeping the chunks for the next parse
+void ASTArena::reset()
+{
+	rewind({0, 0, 0, 0, 0});
+}
+
+/// @brief Memory usage of the arena
+/// @return ArenaStats
+ASTArena::ArenaStats ASTArena::stats() const
+{
+	high_water = std::max(high_water, bytes_used);
+
+	ArenaStats result{bytes_used, 0, chunks.size(), oversized.size(), high_water};
+
+	for (const Chunk &chunk : chunks)
+		result.bytes_reserved += chunk.size;
+
+	for (const Chunk &block : oversized)
+		result.bytes_reserved += block.size;
+
+	return result;
+}
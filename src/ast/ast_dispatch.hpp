@@ -0,0 +1,65 @@
+#ifndef AST_DISPATCH_HPP
+#define AST_DISPATCH_HPP
+
+#include <stdexcept>
+
+#include "./ast_node.hpp"
+
+// ======================
+// -- DISPATCH
+// ======================
+
+/// @brief Call a function object with a node cast to its concrete class, switching on ASTNodeType
+/// @tparam Visitor: Callable with every concrete node class, e.g. NodeOverloads or a generic lambda
+/// @param node: The node
+/// @param visitor: The function object
+/// @return Whatever the chosen overload returns, every overload must return the same type
+/// @note No virtual call is made, the chosen overload can be inlined
+template <typename Visitor>
+	decltype(auto) dispatch_node(ASTNode &node, Visitor &&visitor)
+	{
+		switch (node.Type)
+		{
+			case ASTNodeType::NUMBER:
+				return visitor(static_cast<NumberNode &>(node));
+			case ASTNodeType::VARIABLE:
+				return visitor(static_cast<VariableNode &>(node));
+			case ASTNodeType::SYMBOL:
+				return visitor(static_cast<SymbolNode &>(node));
+			case ASTNodeType::ASSIGN:
+				return visitor(static_cast<AssignNode &>(node));
+			case ASTNodeType::GROUP:
+				return visitor(static_cast<GroupNode &>(node));
+			case ASTNodeType::BINARY_OP:
+				return visitor(static_cast<BinaryOpNode &>(node));
+			case ASTNodeType::UNARY_OP:
+				return visitor(static_cast<UnaryOpNode &>(node));
+			case ASTNodeType::COMMAND:
+				return visitor(static_cast<CommandNode &>(node));
+			case ASTNodeType::SCRIPT:
+				return visitor(static_cast<ScriptNode &>(node));
+			case ASTNodeType::FUNCTION_CALL:
+				return visitor(static_cast<FunctionCallNode &>(node));
+			case ASTNodeType::SEQUENCE:
+				return visitor(static_cast<SequenceNode &>(node));
+			case ASTNodeType::ENVIRONMENT:
+				return visitor(static_cast<EnvironmentNode &>(node));
+			case ASTNodeType::LEFT_RIGHT:
+				return visitor(static_cast<LeftRightNode &>(node));
+		}
+
+		throw std::logic_error("Unknown ASTNodeType");
+	}
+
+/// @brief Overload set built from lambdas, a generic lambda can serve as the fallback
+/// @tparam Fs: Lambda types
+template <typename... Fs>
+	struct NodeOverloads : Fs...
+	{
+		using Fs::operator()...;
+	};
+
+template <typename... Fs>
+	NodeOverloads(Fs...) -> NodeOverloads<Fs...>;
+
+#endif
@@ -1,11 +1,13 @@
 #ifndef AST_INFO_HPP
 #define AST_INFO_HPP
 
+#include <cstdint>
+
 // ======================
 // -- ENUMS / STRUCTS
 // ======================
 
-enum class ASTNodeType
+enum class ASTNodeType : uint8_t
 {
 	NUMBER,
 	VARIABLE,
@@ -22,4 +24,12 @@ enum class ASTNodeType
 	LEFT_RIGHT
 };
 
+/// @brief What constant folding found for a subtree, see ConstantFolder
+enum class FoldState : uint8_t
+{
+	UNFOLDED,     // Not folded yet
+	CONSTANT,     // The subtree evaluates to ASTNode::folded
+	NOT_CONSTANT  // Depends on a variable, or has no single finite value
+};
+
 #endif
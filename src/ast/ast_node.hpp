@@ -1,12 +1,14 @@
 #ifndef AST_NODE_HPP
 #define AST_NODE_HPP
 
-#include <vector>
+#include <cstdint>
 #include <string_view>
 #include <stdexcept>
 
 #include "../parser/data/latex_commands.hpp"
 #include "./ast_info.hpp"
+#include "./ast_arena.hpp"
+#include "./utility/symbol_table.hpp"
 
 // ======================
 // -- ASTVisitor
@@ -18,6 +20,10 @@ class ASTVisitor;
 // -- ASTNode
 // ======================
 
+class ASTNode;
+
+using NodeSpan = ArenaSpan<ASTNode *>;
+
 class ASTNode
 {
 	public:
@@ -26,24 +32,36 @@ class ASTNode
 		// ======================
 
 		ASTNodeType Type;
-		int line;
-		int column;
-
-		// ======================
-		// -- DESTRUCTOR
-		// ======================
+		FoldState fold = FoldState::UNFOLDED; // FoldState: Set by ConstantFolder, shares a word with Type
+		uint32_t offset; // uint32_t: Byte offset into the source, see SourceMap for line / column
+		double folded;   // double: Value of the subtree, only meaningful while fold is CONSTANT
+
+		/// @brief Folded value of the subtree
+		/// @param value: Set to the value if the subtree is constant
+		/// @return True if ConstantFolder found the subtree constant
+		bool constant_value(double &value) const
+		{
+			if (fold != FoldState::CONSTANT)
+				return false;
 
-		virtual ~ASTNode() = default;
+			value = folded;
+			return true;
+		}
 
-		virtual void accept(ASTVisitor &visitor) = 0;
+		/// @brief Call the visitor's visit for this node's concrete class
+		/// @param visitor: The visitor
+		/// @note Dispatches on Type, nodes carry no vtable, see dispatch_node in ast_dispatch.hpp
+		void accept(ASTVisitor &visitor);
 
 	protected:
+		/// @brief Nodes live in an ASTArena and are never destroyed individually
+		~ASTNode() = default;
+
 		/// @brief Construct an AST node
 		/// @param t: Node type
-		/// @param l: Source line
-		/// @param c: Source column
-		ASTNode(ASTNodeType t, int l, int c)
-			: Type(t), line(l), column(c) {}
+		/// @param off: Source byte offset
+		ASTNode(ASTNodeType t, uint32_t off)
+			: Type(t), offset(off) {}
 };
 
 // ======================
@@ -56,10 +74,8 @@ class NumberNode : public ASTNode
 	public:
 		double value;
 
-		NumberNode(double val, int line, int col)
-			: ASTNode(ASTNodeType::NUMBER, line, col), value(val) {}
-
-		void accept(ASTVisitor &v) override;
+		NumberNode(double val, uint32_t off)
+			: ASTNode(ASTNodeType::NUMBER, off), value(val) {}
 };
 
 /// @brief Variable identifier node
@@ -67,11 +83,10 @@ class VariableNode : public ASTNode
 {
 	public:
 		std::string_view name;
+		SymbolId symbol; // SymbolId: Interned name, see Parser::symbols
 
-		VariableNode(std::string_view n, int line, int col)
-			: ASTNode(ASTNodeType::VARIABLE, line, col), name(n) {}
-
-		void accept(ASTVisitor &v) override;
+		VariableNode(std::string_view n, SymbolId sym, uint32_t off)
+			: ASTNode(ASTNodeType::VARIABLE, off), name(n), symbol(sym) {}
 };
 
 /// @brief Symbol node
@@ -80,10 +95,8 @@ class SymbolNode : public ASTNode
 	public:
 		std::string_view symbol;
 
-		SymbolNode(std::string_view sym, int line, int col)
-			: ASTNode(ASTNodeType::SYMBOL, line, col), symbol(sym) {}
-
-		void accept(ASTVisitor &v) override;
+		SymbolNode(std::string_view sym, uint32_t off)
+			: ASTNode(ASTNodeType::SYMBOL, off), symbol(sym) {}
 };
 
 /// @brief Assignment node
@@ -93,11 +106,9 @@ class AssignNode : public ASTNode
 		ASTNode *target;
 		ASTNode *value;
 
-		AssignNode(ASTNode *t, ASTNode *v, int line, int col)
-			: ASTNode(ASTNodeType::ASSIGN, line, col),
+		AssignNode(ASTNode *t, ASTNode *v, uint32_t off)
+			: ASTNode(ASTNodeType::ASSIGN, off),
 			target(t), value(v) {}
-
-		void accept(ASTVisitor &v) override;
 };
 
 // ======================
@@ -108,18 +119,10 @@ class AssignNode : public ASTNode
 class GroupNode : public ASTNode
 {
 	public:
-		std::vector<ASTNode *> elements;
+		NodeSpan elements;
 
-		GroupNode(ASTNode *single, int l, int c)
-			: ASTNode(ASTNodeType::GROUP, l, c)
-		{
-			elements.push_back(single);
-		}
-
-		GroupNode(std::vector<ASTNode *> elms, int l, int c)
-			: ASTNode(ASTNodeType::GROUP, l, c), elements(elms) {}
-
-		void accept(ASTVisitor &v) override;
+		GroupNode(NodeSpan elms, uint32_t off)
+			: ASTNode(ASTNodeType::GROUP, off), elements(elms) {}
 };
 
 /// @brief Binary operation node
@@ -130,11 +133,9 @@ class BinaryOpNode : public ASTNode
 		ASTNode *left;
 		ASTNode *right;
 
-		BinaryOpNode(char operation, ASTNode *l, ASTNode *r, int line, int col)
-			: ASTNode(ASTNodeType::BINARY_OP, line, col),
+		BinaryOpNode(char operation, ASTNode *l, ASTNode *r, uint32_t off)
+			: ASTNode(ASTNodeType::BINARY_OP, off),
 			op(operation), left(l), right(r) {}
-
-		void accept(ASTVisitor &v) override;
 };
 
 /// @brief Unary operation node
@@ -144,11 +145,9 @@ class UnaryOpNode : public ASTNode
 		char op;
 		ASTNode *operand;
 
-		UnaryOpNode(char operation, ASTNode *operand, int line, int col)
-			: ASTNode(ASTNodeType::UNARY_OP, line, col),
+		UnaryOpNode(char operation, ASTNode *operand, uint32_t off)
+			: ASTNode(ASTNodeType::UNARY_OP, off),
 			op(operation), operand(operand) {}
-
-		void accept(ASTVisitor &v) override;
 };
 
 // ======================
@@ -160,19 +159,17 @@ class CommandNode : public ASTNode
 {
 	public:
 		std::string_view name;
-		std::vector<ASTNode *> arguments;
-		const CommandInfo *cmdInfo;
+		NodeSpan arguments;
+		CommandId id;
 
 		CommandNode(std::string_view n,
-				std::vector<ASTNode *> args,
-				const CommandInfo *info,
-				int l, int c)
-			: ASTNode(ASTNodeType::COMMAND, l, c),
+				NodeSpan args,
+				CommandId cmd_id,
+				uint32_t off)
+			: ASTNode(ASTNodeType::COMMAND, off),
 			name(n),
 			arguments(args),
-			cmdInfo(info) {}
-
-		void accept(ASTVisitor &v) override;
+			id(cmd_id) {}
 };
 
 // ======================
@@ -190,8 +187,8 @@ class ScriptNode : public ASTNode
 		ScriptNode(ASTNode *b,
 				ASTNode *sub,
 				ASTNode *sup,
-				int line, int col)
-			: ASTNode(ASTNodeType::SCRIPT, line, col),
+				uint32_t off)
+			: ASTNode(ASTNodeType::SCRIPT, off),
 			base(b),
 			subscript(sub),
 			superscript(sup)
@@ -201,8 +198,6 @@ class ScriptNode : public ASTNode
 			throw std::invalid_argument("ScriptNode must have a non-null base");
 		}
 	}
-
-		void accept(ASTVisitor &v) override;
 };
 
 /// @brief Node representing function calls
@@ -210,30 +205,26 @@ class FunctionCallNode : public ASTNode
 {
 	public:
 		ASTNode *function;
-		std::vector<ASTNode *> args;
+		NodeSpan args;
 
 		FunctionCallNode(
 				ASTNode *func,
-				std::vector<ASTNode *> arguments,
-				int l, int c)
-			: ASTNode(ASTNodeType::FUNCTION_CALL, l, c),
-			function(std::move(func)),
+				NodeSpan arguments,
+				uint32_t off)
+			: ASTNode(ASTNodeType::FUNCTION_CALL, off),
+			function(func),
 			args(arguments) {}
-
-		void accept(ASTVisitor &v) override;
 };
 
 /// @brief Node representing new lines
 class SequenceNode : public ASTNode
 {
 	public:
-		std::vector<ASTNode *> elements;
+		NodeSpan elements;
 
-		SequenceNode(std::vector<ASTNode *> elems, int line, int col)
-			: ASTNode(ASTNodeType::SEQUENCE, line, col),
-			elements(std::move(elems)) {}
-
-		void accept(ASTVisitor &visitor) override;
+		SequenceNode(NodeSpan elems, uint32_t off)
+			: ASTNode(ASTNodeType::SEQUENCE, off),
+			elements(elems) {}
 };
 
 /// @brief Node representing an environment
@@ -241,33 +232,29 @@ class EnvironmentNode : public ASTNode
 {
 	public:
 		std::string_view name;
-		std::vector<std::vector<ASTNode *>> content;
+		ArenaSpan<NodeSpan> content; // ArenaSpan: One NodeSpan per row
 
 		EnvironmentNode(std::string_view n,
-				std::vector<std::vector<ASTNode *>> cont,
-				int l, int c)
-			: ASTNode(ASTNodeType::ENVIRONMENT, l, c),
+				ArenaSpan<NodeSpan> cont,
+				uint32_t off)
+			: ASTNode(ASTNodeType::ENVIRONMENT, off),
 			name(n),
-			content(std::move(cont)) {}
-
-		void accept(ASTVisitor &visitor) override;
+			content(cont) {}
 };
 
 /// @brief Node representing \left <delim> ... \right <delim>
 class LeftRightNode : public ASTNode
 {
 	public:
-		std::string left_delimiter;
-		std::string right_delimiter;
+		std::string_view left_delimiter;
+		std::string_view right_delimiter;
 		ASTNode *content;
 
-		LeftRightNode(std::string left, std::string right, ASTNode *inner, int l, int c)
-			: ASTNode(ASTNodeType::LEFT_RIGHT, l, c),
-			left_delimiter(std::move(left)),
-			right_delimiter(std::move(right)),
+		LeftRightNode(std::string_view left, std::string_view right, ASTNode *inner, uint32_t off)
+			: ASTNode(ASTNodeType::LEFT_RIGHT, off),
+			left_delimiter(left),
+			right_delimiter(right),
 			content(inner) {}
-
-		void accept(ASTVisitor &visitor) override;
 };
 
 #endif
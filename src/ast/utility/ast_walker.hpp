@@ -0,0 +1,54 @@
+#ifndef AST_WALKER_HPP
+#define AST_WALKER_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "../ast_node.hpp"
+#include "../ast_visitor.hpp"
+#include "../ast_dispatch.hpp"
+
+// ======================
+// -- ASTWalker
+// ======================
+
+/// @brief Post-order traversal on an explicit stack, the depth of the AST never touches the call stack
+/// @note Keeps its stacks between walks, reuse one walker to avoid reallocating
+class ASTWalker
+{
+	private:
+		static constexpr size_t MIN_CAPACITY = 64;
+
+		std::vector<ASTNode *> _stack; // std::vector: Buffer of nodes whose children are not pushed yet
+		std::vector<ASTNode *> _order; // std::vector: Buffer of nodes in reverse post-order, visited back to front
+
+		/// @brief Fill _order with every node of an AST in reverse post-order
+		/// @param root: Root of the AST
+		/// @return # of nodes in _order, 0 if root is nullptr
+		size_t collect(ASTNode *root);
+
+	public:
+		// ======================
+		// -- PUBLIC METHODS
+		// ======================
+
+		/// @brief Visit every node of an AST, children left to right before their parent
+		/// @tparam Visitor: An ASTVisitor, or a NodeOverloads dispatched without virtual calls
+		/// @param root: Root of the AST, nothing is visited if nullptr
+		/// @param visitor: The visitor, its visit methods must not visit children themselves
+		/// @note Not reentrant, a visitor must not start another walk on the same walker
+		template <typename Visitor>
+			void post_order(ASTNode *root, Visitor &&visitor)
+			{
+				for (size_t i = collect(root); i-- > 0;)
+				{
+					if constexpr (std::is_base_of_v<ASTVisitor, std::decay_t<Visitor>>)
+						_order[i]->accept(visitor);
+					else
+						dispatch_node(*_order[i], visitor);
+				}
+			}
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include "./ast_walker.hpp"
+
+// ======================
+// -- METHODS
+// ======================
+
+/// @brief Fill _order with every node of an AST in reverse post-order
+/// @param root: Root of the AST
+/// @return # of nodes in _order, 0 if root is nullptr
+size_t ASTWalker::collect(ASTNode *root)
+{
+	if (!root)
+		return 0;
+
+	// The stacks are used as plain buffers indexed by locals, growing only when full
+	if (_stack.size() < MIN_CAPACITY)
+		_stack.resize(MIN_CAPACITY);
+
+	if (_order.size() < MIN_CAPACITY)
+		_order.resize(MIN_CAPACITY);
+
+	size_t stack_top = 0;
+	size_t order_top = 0;
+
+	// Each child is held back until a later sibling shows up, the last one is followed directly
+	ASTNode *last = nullptr;
+
+	auto push = [&](ASTNode *child) {
+		if (!child)
+			return;
+
+		if (last)
+		{
+			if (stack_top == _stack.size())
+				_stack.resize(stack_top * 2);
+
+			_stack[stack_top++] = last;
+		}
+
+		last = child;
+	};
+
+	auto push_span = [&push](const NodeSpan &span) {
+		for (ASTNode *child : span)
+			push(child);
+	};
+
+	// Pre-order with the last child first, reversed it is post-order with the first child first
+	_stack[stack_top++] = root;
+
+	while (stack_top > 0)
+	{
+		ASTNode *node = _stack[--stack_top];
+
+		while (node)
+		{
+			if (order_top == _order.size())
+				_order.resize(order_top * 2);
+
+			_order[order_top++] = node;
+			last = nullptr;
+
+			switch (node->Type)
+			{
+				case ASTNodeType::ASSIGN:
+				{
+					auto *assign = static_cast<AssignNode *>(node);
+					push(assign->target);
+					push(assign->value);
+					break;
+				}
+				case ASTNodeType::GROUP:
+					push_span(static_cast<GroupNode *>(node)->elements);
+					break;
+				case ASTNodeType::BINARY_OP:
+				{
+					auto *binary = static_cast<BinaryOpNode *>(node);
+					push(binary->left);
+					push(binary->right);
+					break;
+				}
+				case ASTNodeType::UNARY_OP:
+					push(static_cast<UnaryOpNode *>(node)->operand);
+					break;
+				case ASTNodeType::COMMAND:
+					push_span(static_cast<CommandNode *>(node)->arguments);
+					break;
+				case ASTNodeType::SCRIPT:
+				{
+					auto *script = static_cast<ScriptNode *>(node);
+					push(script->base);
+					push(script->subscript);
+					push(script->superscript);
+					break;
+				}
+				case ASTNodeType::FUNCTION_CALL:
+				{
+					auto *call = static_cast<FunctionCallNode *>(node);
+					push(call->function);
+					push_span(call->args);
+					break;
+				}
+				case ASTNodeType::SEQUENCE:
+					push_span(static_cast<SequenceNode *>(node)->elements);
+					break;
+				case ASTNodeType::ENVIRONMENT:
+					for (const NodeSpan &row : static_cast<EnvironmentNode *>(node)->content)
+						push_span(row);
+
+					break;
+				case ASTNodeType::LEFT_RIGHT:
+					push(static_cast<LeftRightNode *>(node)->content);
+					break;
+				case ASTNodeType::NUMBER:
+				case ASTNodeType::VARIABLE:
+				case ASTNodeType::SYMBOL:
+					break;
+			}
+
+			node = last;
+		}
+	}
+
+	return order_top;
+}
@@ -0,0 +1,78 @@
+#ifndef CHUNK_POOL_HPP
+#define CHUNK_POOL_HPP
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// ======================
+// -- ChunkPool
+// ======================
+
+/// @brief Process-wide free list of arena chunks, shared by every ASTArena
+/// @note Only power-of-two chunks between MIN_CHUNK_SIZE and MAX_CHUNK_SIZE are pooled
+class ChunkPool
+{
+	public:
+		static constexpr size_t MIN_CHUNK_BITS = 12;
+		static constexpr size_t MAX_CHUNK_BITS = 26;
+		static constexpr size_t MIN_CHUNK_SIZE = size_t{1} << MIN_CHUNK_BITS;
+		static constexpr size_t MAX_CHUNK_SIZE = size_t{1} << MAX_CHUNK_BITS;
+		static constexpr size_t DEFAULT_CAPACITY = size_t{64} << 20;
+
+	private:
+		static constexpr size_t CLASS_COUNT = MAX_CHUNK_BITS - MIN_CHUNK_BITS + 1;
+
+		mutable std::mutex _mutex;
+		std::array<std::vector<std::byte *>, CLASS_COUNT> _free; // std::array: Free chunks per power-of-two size class
+		size_t _pooled = 0;                                      // size_t: Bytes held in _free
+		size_t _capacity = DEFAULT_CAPACITY;                     // size_t: Most bytes _free may hold
+
+		/// @brief Size class of a chunk size
+		/// @param size: Chunk size in bytes
+		/// @return Index into _free, CLASS_COUNT if the size is not pooled
+		static size_t size_class(size_t size);
+
+		ChunkPool() = default;
+
+	public:
+		// ======================
+		// -- PUBLIC METHODS
+		// ======================
+
+		/// @brief The process-wide pool
+		/// @return ChunkPool&, never destroyed so arenas may outlive static destruction order
+		static ChunkPool &instance();
+
+		/// @brief Take a chunk from the pool, allocating one if none is free
+		/// @param size: Chunk size in bytes
+		/// @return std::byte*, release it with the same size
+		std::byte *acquire(size_t size);
+
+		/// @brief Return a chunk to the pool, freeing it if the pool is full or the size is not pooled
+		/// @param chunk: Chunk from acquire
+		/// @param size: Size it was acquired with
+		void release(std::byte *chunk, size_t size);
+
+		/// @brief Set the most bytes the pool keeps, 0 disables pooling
+		/// @param bytes: Capacity in bytes, free chunks above it are released
+		void set_capacity(size_t bytes);
+
+		/// @brief Bytes currently held by the pool
+		/// @return size_t
+		size_t pooled_bytes() const;
+
+		// ======================
+		// -- MISC
+		// ======================
+
+		/// @brief Prevent copies, there is one pool per process
+		ChunkPool(const ChunkPool &) = delete;
+
+		/// @brief Prevent copies, there is one pool per process
+		/// @return ChunkPool
+		ChunkPool &operator=(const ChunkPool &) = delete;
+};
+
+#endif
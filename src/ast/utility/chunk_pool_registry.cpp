@@ -0,0 +1,109 @@
+#include "./chunk_pool.hpp"
+
+// ======================
+// -- INIT
+// ======================
+
+/// @brief The process-wide pool
+/// @return ChunkPool&, never destroyed so arenas may outlive static destruction order
+ChunkPool &ChunkPool::instance()
+{
+	static ChunkPool *pool = new ChunkPool();
+	return *pool;
+}
+
+/// @brief Size class of a chunk size
+/// @param size: Chunk size in bytes
+/// @return Index into _free, CLASS_COUNT if the size is not pooled
+size_t ChunkPool::size_class(size_t size)
+{
+	if (size < MIN_CHUNK_SIZE || size > MAX_CHUNK_SIZE || (size & (size - 1)) != 0)
+		return CLASS_COUNT;
+
+	size_t bits = 0;
+
+	while ((size_t{1} << bits) < size)
+		bits++;
+
+	return bits - MIN_CHUNK_BITS;
+}
+
+// ======================
+// -- PUBLIC METHODS
+// ======================
+
+/// @brief Take a chunk from the pool, allocating one if none is free
+/// @param size: Chunk size in bytes
+/// @return std::byte*, release it with the same size
+std::byte *ChunkPool::acquire(size_t size)
+{
+	size_t index = size_class(size);
+
+	if (index < CLASS_COUNT)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto &free_list = _free[index];
+
+		if (!free_list.empty())
+		{
+			std::byte *chunk = free_list.back();
+			free_list.pop_back();
+			_pooled -= size;
+			return chunk;
+		}
+	}
+
+	return new std::byte[size];
+}
+
+/// @brief Return a chunk to the pool, freeing it if the pool is full or the size is not pooled
+/// @param chunk: Chunk from acquire
+/// @param size: Size it was acquired with
+void ChunkPool::release(std::byte *chunk, size_t size)
+{
+	size_t index = size_class(size);
+
+	if (index < CLASS_COUNT)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		if (_pooled + size <= _capacity)
+		{
+			_free[index].push_back(chunk);
+			_pooled += size;
+			return;
+		}
+	}
+
+	delete[] chunk;
+}
+
+/// @brief Set the most bytes the pool keeps, 0 disables pooling
+/// @param bytes: Capacity in bytes, free chunks above it are released
+void ChunkPool::set_capacity(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_capacity = bytes;
+
+	// Drop the largest chunks first, they are the least likely to be asked for again
+	for (size_t index = CLASS_COUNT; index-- > 0 && _pooled > _capacity;)
+	{
+		auto &free_list = _free[index];
+		size_t size = MIN_CHUNK_SIZE << index;
+
+		while (!free_list.empty() && _pooled > _capacity)
+		{
+			delete[] free_list.back();
+			free_list.pop_back();
+			_pooled -= size;
+		}
+	}
+}
+
+/// @brief Bytes currently held by the pool
+/// @return size_t
+size_t ChunkPool::pooled_bytes() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _pooled;
+}
@@ -0,0 +1,122 @@
+#ifndef CONSTANT_FOLDER_HPP
+#define CONSTANT_FOLDER_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "../ast_node.hpp"
+#include "./ast_walker.hpp"
+
+// ======================
+// -- ConstantFolder
+// ======================
+
+/// @brief Folds constant subtrees bottom-up, caching on each node whether it is constant and its value
+/// @note Folding a node only reads the cache of its children, so one post-order walk folds a whole AST and
+/// later passes read ASTNode::constant_value instead of evaluating again
+class ConstantFolder
+{
+	private:
+		static constexpr double MAX_BINOMIAL_STEPS = 1024.0; // double: Largest min(k, n - k) \binom folds
+
+		ASTWalker _walker; // ASTWalker: Explicit traversal stack, kept between trees
+
+		/// @brief Value of a folded operand
+		/// @param operand: The operand, may be nullptr
+		/// @param value: Set to the value if operand is constant
+		/// @return True if operand is constant
+		static bool operand_value(const ASTNode *operand, double &value)
+		{
+			return operand && operand->constant_value(value);
+		}
+
+		/// @brief Fold a node with children
+		/// @param node: The node
+		static void fold_operation(ASTNode &node);
+
+		/// @brief Fold a unary operation
+		/// @param node: The node
+		/// @param value: Set to the value if constant
+		/// @return True if constant
+		static bool fold_unary(const UnaryOpNode &node, double &value);
+
+		/// @brief Fold a binary operation
+		/// @param node: The node
+		/// @param value: Set to the value if constant
+		/// @return True if constant
+		static bool fold_binary(const BinaryOpNode &node, double &value);
+
+		/// @brief Fold a command with a known meaning, e.g. \frac or \sin
+		/// @param node: The node
+		/// @param value: Set to the value if constant
+		/// @return True if constant
+		static bool fold_command(const CommandNode &node, double &value);
+
+		/// @brief Fold \sqrt{x} or \sqrt[n]{x}
+		/// @param node: The node, its arguments are [index, radicand]
+		/// @param value: Set to the value if constant
+		/// @return True if constant
+		static bool fold_root(const CommandNode &node, double &value);
+
+		/// @brief Fold a call of a function command, e.g. \sin{0} or \ln(1)
+		/// @param node: The node
+		/// @param value: Set to the value if constant
+		/// @return True if constant
+		static bool fold_call(const FunctionCallNode &node, double &value);
+
+		/// @brief Apply a function command to one argument
+		/// @param id: The command
+		/// @param argument: Its argument
+		/// @param value: Set to the result if id is a known function
+		/// @return True if id is a known function
+		static bool apply_function(CommandId id, double argument, double &value);
+
+		/// @brief Fold a \left ... \right pair with parentheses, brackets or bars
+		/// @param node: The node
+		/// @param value: Set to the value if constant
+		/// @return True if constant
+		static bool fold_left_right(const LeftRightNode &node, double &value);
+
+	public:
+		// ======================
+		// -- PUBLIC METHODS
+		// ======================
+
+		/// @brief Fold one node, every node below it must be folded already
+		/// @param node: The node
+		/// @note A value that is not finite, e.g. of 1/0 or \ln{0}, folds to NOT_CONSTANT
+		static void fold(ASTNode &node)
+		{
+			switch (node.Type)
+			{
+				case ASTNodeType::NUMBER:
+				{
+					double value = static_cast<const NumberNode &>(node).value;
+
+					node.fold = std::isfinite(value) ? FoldState::CONSTANT : FoldState::NOT_CONSTANT;
+					node.folded = value;
+					break;
+				}
+				case ASTNodeType::VARIABLE:
+				case ASTNodeType::SYMBOL:
+				case ASTNodeType::ASSIGN:
+				case ASTNodeType::SEQUENCE:
+				case ASTNodeType::ENVIRONMENT:
+					node.fold = FoldState::NOT_CONSTANT;
+					break;
+				default:
+					fold_operation(node);
+					break;
+			}
+		}
+
+		/// @brief Fold every node of an AST, e.g. one that was parsed but not analyzed
+		/// @param root: Root of the AST, nothing is folded if nullptr
+		void fold_tree(ASTNode *root)
+		{
+			_walker.post_order(root, [](ASTNode &node) { fold(node); });
+		}
+};
+
+#endif
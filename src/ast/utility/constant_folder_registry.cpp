@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <cmath>
+
+#include "./constant_folder.hpp"
+
+// ======================
+// -- METHODS
+// ======================
+
+/// @brief Fold a node with children
+/// @param node: The node
+void ConstantFolder::fold_operation(ASTNode &node)
+{
+	double value = 0.0;
+	bool constant = false;
+
+	switch (node.Type)
+	{
+		case ASTNodeType::GROUP:
+		{
+			const auto &group = static_cast<const GroupNode &>(node);
+			constant = group.elements.size() == 1 && operand_value(group.elements[0], value);
+			break;
+		}
+		case ASTNodeType::UNARY_OP:
+			constant = fold_unary(static_cast<const UnaryOpNode &>(node), value);
+			break;
+		case ASTNodeType::BINARY_OP:
+			constant = fold_binary(static_cast<const BinaryOpNode &>(node), value);
+			break;
+		case ASTNodeType::COMMAND:
+			constant = fold_command(static_cast<const CommandNode &>(node), value);
+			break;
+		case ASTNodeType::SCRIPT:
+		{
+			// Only a power, a subscript names something, e.g. x_1
+			const auto &script = static_cast<const ScriptNode &>(node);
+			double exponent;
+
+			constant = !script.subscript && operand_value(script.base, value) && operand_value(script.superscript, exponent);
+
+			if (constant)
+				value = std::pow(value, exponent);
+
+			break;
+		}
+		case ASTNodeType::FUNCTION_CALL:
+			constant = fold_call(static_cast<const FunctionCallNode &>(node), value);
+			break;
+		case ASTNodeType::LEFT_RIGHT:
+			constant = fold_left_right(static_cast<const LeftRightNode &>(node), value);
+			break;
+		default:
+			break;
+	}
+
+	if (constant && std::isfinite(value))
+	{
+		node.fold = FoldState::CONSTANT;
+		node.folded = value;
+	}
+	else
+	{
+		node.fold = FoldState::NOT_CONSTANT;
+	}
+}
+
+/// @brief Fold a unary operation
+/// @param node: The node
+/// @param value: Set to the value if constant
+/// @return True if constant
+bool ConstantFolder::fold_unary(const UnaryOpNode &node, double &value)
+{
+	double operand;
+
+	if (!operand_value(node.operand, operand))
+		return false;
+
+	switch (node.op)
+	{
+		case '-':
+			value = -operand;
+			return true;
+		case '+':
+			value = operand;
+			return true;
+		case '!':
+			// Past 170! the value overflows a double
+			if (operand < 0.0 || operand > 170.0 || operand != std::floor(operand))
+				return false;
+
+			value = std::tgamma(operand + 1.0);
+			return true;
+		default:
+			return false;
+	}
+}
+
+/// @brief Fold a binary operation
+/// @param node: The node
+/// @param value: Set to the value if constant
+/// @return True if constant
+bool ConstantFolder::fold_binary(const BinaryOpNode &node, double &value)
+{
+	double left, right;
+
+	if (!operand_value(node.left, left) || !operand_value(node.right, right))
+		return false;
+
+	switch (node.op)
+	{
+		case '+':
+			value = left + right;
+			return true;
+		case '-':
+			value = left - right;
+			return true;
+		case '*':
+			value = left * right;
+			return true;
+		case '/':
+			value = left / right;
+			return true;
+		case '^':
+			value = std::pow(left, right);
+			return true;
+		default:
+			// Relations, assignments and +- have no single value
+			return false;
+	}
+}
+
+/// @brief Fold a command with a known meaning, e.g. \frac or \sin
+/// @param node: The node
+/// @param value: Set to the value if constant
+/// @return True if constant
+bool ConstantFolder::fold_command(const CommandNode &node, double &value)
+{
+	// Optional arguments come first and are nullptr when left out, only \sqrt has one
+	if (node.id == CommandId::SQRT)
+		return fold_root(node, value);
+
+	const NodeSpan &arguments = node.arguments;
+	double first, second;
+
+	if (arguments.empty() || !operand_value(arguments[0], first))
+		return false;
+
+	if (arguments.size() == 2)
+	{
+		if (!operand_value(arguments[1], second))
+			return false;
+
+		switch (node.id)
+		{
+			case CommandId::FRAC:
+				value = first / second;
+				return true;
+			case CommandId::BINOM:
+			case CommandId::CHOOSE:
+			{
+				if (first < 0.0 || second < 0.0 || first != std::floor(first) || second != std::floor(second))
+					return false;
+
+				double steps = std::min(second, first - second);
+
+				if (steps > MAX_BINOMIAL_STEPS)
+					return false;
+
+				value = steps < 0.0 ? 0.0 : 1.0;
+
+				for (double i = 1.0; i <= steps; i++)
+					value = value * (first - steps + i) / i;
+
+				return true;
+			}
+			default:
+				return false;
+		}
+	}
+
+	return arguments.size() == 1 && apply_function(node.id, first, value);
+}
+
+/// @brief Fold \sqrt{x} or \sqrt[n]{x}
+/// @param node: The node, its arguments are [index, radicand]
+/// @param value: Set to the value if constant
+/// @return True if constant
+bool ConstantFolder::fold_root(const CommandNode &node, double &value)
+{
+	const NodeSpan &arguments = node.arguments;
+	double radicand, index = 2.0;
+
+	if (arguments.empty() || !operand_value(arguments[arguments.size() - 1], radicand) || radicand < 0.0)
+		return false;
+
+	// A left out index is nullptr and means a square root
+	if (arguments.size() == 2 && arguments[0] && !operand_value(arguments[0], index))
+		return false;
+
+	value = index == 2.0 ? std::sqrt(radicand) : std::pow(radicand, 1.0 / index);
+	return true;
+}
+
+/// @brief Fold a call of a function command, e.g. \sin{0} or \ln(1)
+/// @param node: The node
+/// @param value: Set to the value if constant
+/// @return True if constant
+bool ConstantFolder::fold_call(const FunctionCallNode &node, double &value)
+{
+	double argument;
+
+	if (!node.function || node.function->Type != ASTNodeType::COMMAND || node.args.size() != 1 || !operand_value(node.args[0], argument))
+		return false;
+
+	const auto *command = static_cast<const CommandNode *>(node.function);
+
+	return command->arguments.empty() && apply_function(command->id, argument, value);
+}
+
+/// @brief Apply a function command to one argument
+/// @param id: The command
+/// @param argument: Its argument
+/// @param value: Set to the result if id is a known function
+/// @return True if id is a known function
+bool ConstantFolder::apply_function(CommandId id, double argument, double &value)
+{
+	// \log is left out, its base depends on the field
+	switch (id)
+	{
+		case CommandId::SIN:
+			value = std::sin(argument);
+			return true;
+		case CommandId::COS:
+			value = std::cos(argument);
+			return true;
+		case CommandId::TAN:
+			value = std::tan(argument);
+			return true;
+		case CommandId::SEC:
+			value = 1.0 / std::cos(argument);
+			return true;
+		case CommandId::CSC:
+			value = 1.0 / std::sin(argument);
+			return true;
+		case CommandId::COT:
+			value = std::cos(argument) / std::sin(argument);
+			return true;
+		case CommandId::SINH:
+			value = std::sinh(argument);
+			return true;
+		case CommandId::COSH:
+			value = std::cosh(argument);
+			return true;
+		case CommandId::TANH:
+			value = std::tanh(argument);
+			return true;
+		case CommandId::ARCSIN:
+			value = std::asin(argument);
+			return true;
+		case CommandId::ARCCOS:
+			value = std::acos(argument);
+			return true;
+		case CommandId::ARCTAN:
+			value = std::atan(argument);
+			return true;
+		case CommandId::LN:
+			value = std::log(argument);
+			return true;
+		case CommandId::EXP:
+			value = std::exp(argument);
+			return true;
+		default:
+			return false;
+	}
+}
+
+/// @brief Fold a \left ... \right pair with parentheses, brackets or bars
+/// @param node: The node
+/// @param value: Set to the value if constant
+/// @return True if constant
+bool ConstantFolder::fold_left_right(const LeftRightNode &node, double &value)
+{
+	if (!operand_value(node.content, value))
+		return false;
+
+	if (node.left_delimiter == "|" && node.right_delimiter == "|")
+	{
+		value = std::fabs(value);
+		return true;
+	}
+
+	return (node.left_delimiter == "(" && node.right_delimiter == ")") ||
+		(node.left_delimiter == "[" && node.right_delimiter == "]");
+}
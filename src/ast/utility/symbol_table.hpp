@@ -0,0 +1,127 @@
+#ifndef SYMBOL_TABLE_HPP
+#define SYMBOL_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ======================
+// -- ENUMS / STRUCTS
+// ======================
+
+/// @brief Dense id of an interned name, 0 for the first name interned
+using SymbolId = uint32_t;
+
+// ======================
+// -- SymbolTable
+// ======================
+
+/// @brief Interns names to dense SymbolIds, so later passes index flat vectors instead of hashing strings
+/// @note Names are copied, ids stay valid across inputs until clear()
+class SymbolTable
+{
+	public:
+		static constexpr SymbolId NO_SYMBOL = UINT32_MAX;
+		static constexpr size_t RETAIN_LIMIT = size_t{1} << 16; // size_t: Most names a long-lived owner should keep, see Parser::reset
+
+	private:
+		static constexpr size_t MIN_SLOTS = 64;
+
+		/// @brief Open-addressing slot
+		struct Slot
+		{
+			uint32_t hash = 0;        // uint32_t: Hash of the name
+			SymbolId id = NO_SYMBOL;  // SymbolId: NO_SYMBOL if the slot is empty
+		};
+
+		std::string _text;                  // std::string: Every name back to back
+		std::vector<uint32_t> _ends;        // std::vector: End of each name in _text, indexed by SymbolId
+		std::vector<Slot> _slots;           // std::vector: Power-of-two hash table, at most half full
+		std::array<SymbolId, 128> _ascii;   // std::array: Id of each single ASCII character name, skips the hash
+
+		/// @brief Hash of a name
+		/// @param name: The name
+		/// @return uint32_t
+		static uint32_t hash(std::string_view name);
+
+		/// @brief Add a name that is not interned yet
+		/// @param name: The name
+		/// @param name_hash: Hash of the name
+		/// @return SymbolId
+		SymbolId insert(std::string_view name, uint32_t name_hash);
+
+		/// @brief Double the slots and re-insert every name
+		void grow();
+
+	public:
+		// ======================
+		// -- CONSTRUCTOR
+		// ======================
+
+		/// @brief Empty table
+		SymbolTable() { _ascii.fill(NO_SYMBOL); }
+
+		// ======================
+		// -- PUBLIC METHODS
+		// ======================
+
+		/// @brief Id of a name, interning it if new
+		/// @param name: The name, copied
+		/// @return SymbolId
+		SymbolId intern(std::string_view name)
+		{
+			if (name.size() == 1 && static_cast<unsigned char>(name[0]) < _ascii.size()) [[likely]]
+			{
+				SymbolId &id = _ascii[static_cast<unsigned char>(name[0])];
+
+				if (id == NO_SYMBOL)
+					id = insert(name, hash(name));
+
+				return id;
+			}
+
+			uint32_t name_hash = hash(name);
+			SymbolId id = find(name, name_hash);
+
+			return id != NO_SYMBOL ? id : insert(name, name_hash);
+		}
+
+		/// @brief Id of an interned name
+		/// @param name: The name
+		/// @return SymbolId, NO_SYMBOL if the name was never interned
+		SymbolId find(std::string_view name) const { return find(name, hash(name)); }
+
+		/// @brief Id of an interned name
+		/// @param name: The name
+		/// @param name_hash: Hash of the name
+		/// @return SymbolId, NO_SYMBOL if the name was never interned
+		SymbolId find(std::string_view name, uint32_t name_hash) const;
+
+		/// @brief Name of an id
+		/// @param id: Id from intern
+		/// @return std::string_view, valid until the next intern or clear
+		std::string_view name(SymbolId id) const
+		{
+			uint32_t begin = id == 0 ? 0 : _ends[id - 1];
+			return std::string_view(_text.data() + begin, _ends[id] - begin);
+		}
+
+		/// @brief # of interned names, every id is below it
+		/// @return size_t
+		size_t size() const { return _ends.size(); }
+
+		/// @brief Forget every name, keeping the storage
+		void clear();
+
+		/// @brief Heap bytes held by the table
+		/// @return size_t
+		size_t memory_usage() const
+		{
+			return _text.capacity() + _ends.capacity() * sizeof(uint32_t) + _slots.capacity() * sizeof(Slot);
+		}
+};
+
+#endif
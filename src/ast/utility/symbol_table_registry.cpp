@@ -0,0 +1,102 @@
+#include "./symbol_table.hpp"
+
+// ======================
+// -- METHODS
+// ======================
+
+/// @brief Hash of a name
+/// @param name: The name
+/// @return uint32_t
+uint32_t SymbolTable::hash(std::string_view name)
+{
+	// FNV-1a, names are short
+	uint32_t value = 0x811C9DC5u;
+
+	for (char c : name)
+	{
+		value ^= static_cast<unsigned char>(c);
+		value *= 0x01000193u;
+	}
+
+	return value;
+}
+
+/// @brief Id of an interned name
+/// @param name: The name
+/// @param name_hash: Hash of the name
+/// @return SymbolId, NO_SYMBOL if the name was never interned
+SymbolId SymbolTable::find(std::string_view name, uint32_t name_hash) const
+{
+	if (_slots.empty())
+		return NO_SYMBOL;
+
+	size_t mask = _slots.size() - 1;
+
+	for (size_t i = name_hash & mask;; i = (i + 1) & mask)
+	{
+		const Slot &slot = _slots[i];
+
+		if (slot.id == NO_SYMBOL)
+			return NO_SYMBOL;
+
+		if (slot.hash == name_hash && this->name(slot.id) == name)
+			return slot.id;
+	}
+}
+
+/// @brief Add a name that is not interned yet
+/// @param name: The name
+/// @param name_hash: Hash of the name
+/// @return SymbolId
+SymbolId SymbolTable::insert(std::string_view name, uint32_t name_hash)
+{
+	if ((_ends.size() + 1) * 2 > _slots.size())
+		grow();
+
+	SymbolId id = static_cast<SymbolId>(_ends.size());
+
+	_text.append(name);
+	_ends.push_back(static_cast<uint32_t>(_text.size()));
+
+	size_t mask = _slots.size() - 1;
+	size_t i = name_hash & mask;
+
+	while (_slots[i].id != NO_SYMBOL)
+		i = (i + 1) & mask;
+
+	_slots[i] = {name_hash, id};
+
+	return id;
+}
+
+/// @brief Double the slots and re-insert every name
+void SymbolTable::grow()
+{
+	std::vector<Slot> old = std::move(_slots);
+
+	_slots.assign(old.empty() ? MIN_SLOTS : old.size() * 2, Slot{});
+
+	size_t mask = _slots.size() - 1;
+
+	for (const Slot &slot : old)
+	{
+		if (slot.id == NO_SYMBOL)
+			continue;
+
+		size_t i = slot.hash & mask;
+
+		while (_slots[i].id != NO_SYMBOL)
+			i = (i + 1) & mask;
+
+		_slots[i] = slot;
+	}
+}
+
+/// @brief Forget every name, keeping the storage
+void SymbolTable::clear()
+{
+	_text.clear();
+	_ends.clear();
+	_slots.assign(_slots.size(), Slot{});
+	_ascii.fill(NO_SYMBOL);
+}
@@ -0,0 +1,60 @@
+#include "./latex_batch.hpp"
+
+// ======================
+// -- INIT
+// ======================
+
+/// @brief Start the workers
+/// @param opts: Thread count and chunking
+LatexBatch::LatexBatch(BatchOptions opts) : options(opts), pool(opts.threads)
+{
+	engines.reserve(pool.size());
+
+	for (size_t i = 0; i < pool.size(); i++)
+		engines.push_back(std::make_unique<LatexEngine>());
+}
+
+// ======================
+// -- PUBLIC METHODS
+// ======================
+
+/// @brief Lex, parse and analyze every text in parallel
+/// @param texts: First text, borrowed (not copied)
+/// @param count: # of texts
+/// @return One BatchItem per text, in input order
+/// @throws std::length_error if a text is 4 GiB or larger
+std::vector<BatchItem> LatexBatch::process_batch(const std::string_view *texts, size_t count)
+{
+	std::vector<BatchItem> items(count);
+
+	// Only diagnostics are returned, so the AST is never kept
+	pool.parallel_for(count, options.chunk_size, [&](size_t worker, size_t begin, size_t end) {
+			LatexEngine &engine = *engines[worker];
+
+			for (size_t i = begin; i < end; i++)
+			{
+				LatexView view = engine.validate(texts[i], options.rules);
+				BatchItem &item = items[i];
+				item.parse_error = view.parse_error;
+				item.errors.assign(view.errors->begin(), view.errors->end());
+				item.token_count = static_cast<uint32_t>(view.tokens->size());
+			}
+			});
+
+	return items;
+}
+
+/// @brief Lex, parse and analyze every text in parallel, handing each view to a visitor
+/// @param texts: First text, borrowed (not copied)
+/// @param count: # of texts
+/// @param visitor: Called once per text on the worker that processed it, in no particular order
+/// @throws std::length_error if a text is 4 GiB or larger, or whatever visitor throws
+void LatexBatch::process_batch(const std::string_view *texts, size_t count, const BatchVisitor &visitor)
+{
+	pool.parallel_for(count, options.chunk_size, [&](size_t worker, size_t begin, size_t end) {
+			LatexEngine &engine = *engines[worker];
+
+			for (size_t i = begin; i < end; i++)
+				visitor(i, engine.process(texts[i], options.rules));
+			});
+}
@@ -7,18 +7,32 @@
 // -- INIT
 // ======================
 
+/// @brief Lex, parse and analyze source
+void LatexCore::run()
+{
+	lexer.tokenize(tokens);
+
+	parser.reset(tokens);
+	root = parser.parse();
+
+	analyzer.analyze(root);
+}
+
 /// @brief Print the tokens generated by the lexer
 /// @note [DEBUG]
 void LatexCore::print_tokens()
 {
 	std::cout << "Tokens (" << tokens.size() << "):\n";
 
-	for (const auto &token : tokens)
+	for (size_t i = 0; i < tokens.size(); i++)
 	{
+		Token token = tokens[i];
+		SourceLocation loc = parser.source_map().locate(token.offset);
+
 		std::cout << "  "
 			<< static_cast<int>(token.Type)
 			<< " : " << token.Value
-			<< " @ " << token.line << ":" << token.column
+			<< " @ " << loc.line << ":" << loc.column
 			<< "\n";
 	}
 };
@@ -27,20 +41,25 @@ void LatexCore::print_tokens()
 /// @note [DEBUG]
 void LatexCore::print_analysis()
 {
+	const std::vector<SemanticError> &errors = analyzer.get_errors();
+
 	std::cout << "Errors (" << errors.size() << "):\n";
 
 	for (const auto &error : errors)
 	{
+		SourceLocation loc = locate(error);
+
 		std::cout << "  "
-			<< error.message
-			<< " @ " << error.line << ":" << error.column
+			<< diagnostic_text(error.code)
+			<< " @ " << loc.line << ":" << loc.column
 			<< "\n";
 	}
 };
 
-/// @brief Return analysis results
-/// @return std::vector<SemanticError>
-std::vector<SemanticError> LatexCore::return_errors()
+/// @brief Line and column of a semantic error
+/// @param error: An error from return_errors()
+/// @return SourceLocation
+SourceLocation LatexCore::locate(const SemanticError &error) const
 {
-	return analyzer.get_errors();
+	return parser.source_map().locate(error.offset);
 }
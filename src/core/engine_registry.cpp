@@ -0,0 +1,54 @@
+#include "./latex_engine.hpp"
+
+// ======================
+// -- PUBLIC METHODS
+// ======================
+
+/// @brief Lex, parse and analyze a text
+/// @param text: The text to process, borrowed (not copied)
+/// @param rules: Semantic rules to run, see RuleSets
+/// @return LatexView, valid until the next call
+/// @throws std::length_error if the text is 4 GiB or larger
+LatexView LatexEngine::process(std::string_view text, RuleSet rules)
+{
+	lexer.reset(text);
+	lexer.tokenize(tokens);
+
+	parser.reset(tokens);
+
+	ParseResult parsed = parser.try_parse();
+
+	analyzer.set_rules(rules);
+
+	if (parsed.ok())
+		analyzer.analyze(parsed.root);
+	else
+		analyzer.clear();
+
+	return {&tokens, parsed.root, parsed.error, &analyzer.get_errors()};
+}
+
+/// @brief Lex a text, then parse and analyze it in one pass without keeping the AST
+/// @param text: The text to process, borrowed (not copied)
+/// @param rules: Semantic rules to run, see RuleSets
+/// @return LatexView with a nullptr root and the same diagnostics process() reports, valid until the next call
+/// @throws std::length_error if the text is 4 GiB or larger
+LatexView LatexEngine::validate(std::string_view text, RuleSet rules)
+{
+	lexer.reset(text);
+	lexer.tokenize(tokens);
+
+	parser.reset(tokens);
+
+	analyzer.set_rules(rules);
+	analyzer.begin_nodes();
+	Parser::NodeHooks hooks{&analyzer, &SemanticAnalyzer::built_hook, &SemanticAnalyzer::mark_hook, &SemanticAnalyzer::drop_hook};
+	ParseResult parsed = parser.try_validate(hooks);
+
+	if (parsed.ok())
+		analyzer.end_nodes();
+	else
+		analyzer.clear();
+
+	return {&tokens, nullptr, parsed.error, &analyzer.get_errors()};
+}
@@ -0,0 +1,97 @@
+#ifndef LATEX_BATCH_HPP
+#define LATEX_BATCH_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "./latex_engine.hpp"
+#include "./utility/work_stealing_pool.hpp"
+
+// ======================
+// -- ENUMS / STRUCTS
+// ======================
+
+struct BatchOptions
+{
+	size_t threads = 0;                // size_t: # of workers including the caller, 0 for std::thread::hardware_concurrency
+	size_t chunk_size = 16;            // size_t: Inputs a worker claims at a time, smaller balances uneven inputs better
+	RuleSet rules = RuleSets::DEFAULT; // RuleSet: Semantic rules run on every input
+};
+
+/// @brief Outcome of one input of a batch, owns its errors
+struct BatchItem
+{
+	Diagnostic parse_error;            // Diagnostic: DiagnosticCode::NONE if the text parsed
+	std::vector<SemanticError> errors; // std::vector: Semantic errors, empty on a parse error
+	uint32_t token_count = 0;          // uint32_t: # of tokens including END_OF_FILE
+
+	/// @brief Check if the text parsed and analyzed without errors
+	/// @return True on success
+	bool ok() const { return parse_error.code == DiagnosticCode::NONE && errors.empty(); }
+};
+
+/// @brief Called on a worker thread with the input index and its LatexView, the view is only valid during the call
+using BatchVisitor = std::function<void(size_t index, const LatexView &view)>;
+
+// ======================
+// -- LatexBatch
+// ======================
+
+/// @brief Processes batches of independent texts on a work-stealing pool
+/// @note Every worker owns a LatexEngine (and so its own arena), engines and threads live as long as the LatexBatch
+class LatexBatch
+{
+	private:
+		// ======================
+		// -- BATCH DATA
+		// ======================
+
+		BatchOptions options;
+		WorkStealingPool pool;
+		std::vector<std::unique_ptr<LatexEngine>> engines; // std::vector: One engine per worker
+
+	public:
+		// ======================
+		// -- CONSTRUCTOR
+		// ======================
+
+		/// @brief Start the workers
+		/// @param opts: Thread count and chunking
+		explicit LatexBatch(BatchOptions opts = {});
+
+		// ======================
+		// -- PUBLIC METHODS
+		// ======================
+
+		/// @brief # of workers including the caller
+		/// @return size_t
+		size_t threads() const { return pool.size(); }
+
+		/// @brief Lex, parse and analyze every text in parallel
+		/// @param texts: First text, borrowed (not copied)
+		/// @param count: # of texts
+		/// @return One BatchItem per text, in input order
+		/// @throws std::length_error if a text is 4 GiB or larger
+		std::vector<BatchItem> process_batch(const std::string_view *texts, size_t count);
+
+		/// @brief Lex, parse and analyze every text in parallel
+		/// @param texts: The texts, borrowed (not copied)
+		/// @return One BatchItem per text, in input order
+		/// @throws std::length_error if a text is 4 GiB or larger
+		std::vector<BatchItem> process_batch(const std::vector<std::string_view> &texts)
+		{
+			return process_batch(texts.data(), texts.size());
+		}
+
+		/// @brief Lex, parse and analyze every text in parallel, handing each view to a visitor
+		/// @param texts: First text, borrowed (not copied)
+		/// @param count: # of texts
+		/// @param visitor: Called once per text on the worker that processed it, in no particular order
+		/// @throws std::length_error if a text is 4 GiB or larger, or whatever visitor throws
+		void process_batch(const std::string_view *texts, size_t count, const BatchVisitor &visitor);
+};
+
+#endif
@@ -2,11 +2,13 @@
 #define LATEX_CORE_HPP
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "../sem_analyzer/semantic_analyzer.hpp"
 #include "../lexer/lexer.hpp"
 #include "../parser/parser.hpp"
+#include "./utility/mapped_file.hpp"
 
 class LatexCore
 {
@@ -16,9 +18,11 @@ class LatexCore
 		// ======================
 
 		std::string input_text;
+		MappedFile input_file;
+		std::string_view source;
 
-		std::vector<Token> tokens;
-		std::vector<SemanticError> errors;
+		TokenStream tokens;
+		ASTNode *root = nullptr; // ASTNode*: Root of the AST, owned by parser
 
 		Lexer lexer;
 		Parser parser;
@@ -28,19 +32,45 @@ class LatexCore
 		// -- CONSTRUCTOR
 		// ======================
 
-		/// @brief Constructor for Latex Core
+		/// @brief Constructor for Latex Core, borrows the text without copying it
 		/// @param text The text to process
-		LatexCore(std::string text) : input_text(std::move(text)), lexer(input_text)
+		/// @note text must outlive this LatexCore, tokens point into it
+		LatexCore(std::string_view text) : source(text), lexer(source)
 	{
-		tokens = lexer.tokenize();
+		run();
+	}
+
+		/// @brief Constructor for Latex Core, borrows the text without copying it
+		/// @param text The null-terminated text to process
+		/// @note text must outlive this LatexCore, tokens point into it
+		LatexCore(const char *text) : LatexCore(std::string_view(text)) {}
 
-		Parser parser_exec(tokens);
-		auto ast = parser_exec.parse();
+		/// @brief Constructor for Latex Core, takes ownership of the text
+		/// @param text The text to process
+		LatexCore(std::string &&text) : input_text(std::move(text)), source(input_text), lexer(source)
+	{
+		run();
+	}
 
-		analyzer.analyze(ast);
-		errors = analyzer.get_errors();
+		/// @brief Constructor for Latex Core, takes ownership of a mapped file
+		/// @param file The mapped file to process, e.g. LatexCore core{MappedFile("paper.tex")}
+		/// @note Tokens point straight into the mapping, the file is never copied
+		LatexCore(MappedFile &&file) : input_file(std::move(file)), source(input_file.view()), lexer(source)
+	{
+		run();
 	}
 
+		// ======================
+		// -- MISC
+		// ======================
+
+		/// @brief Prevent copies, tokens point into source
+		LatexCore(const LatexCore &) = delete;
+
+		/// @brief Prevent copies, tokens point into source
+		/// @return LatexCore
+		LatexCore &operator=(const LatexCore &) = delete;
+
 		// ======================
 		// -- PUBLIC METHODS
 		// ======================
@@ -54,8 +84,21 @@ class LatexCore
 		void print_analysis();
 
 		/// @brief Return analysis results
-		/// @return std::vector<SemanticError>
-		std::vector<SemanticError> return_errors();
+		/// @return const std::vector<SemanticError>&
+		const std::vector<SemanticError> &return_errors() const { return analyzer.get_errors(); }
+
+		/// @brief Line and column of a semantic error
+		/// @param error: An error from return_errors()
+		/// @return SourceLocation
+		SourceLocation locate(const SemanticError &error) const;
+
+	private:
+		// ======================
+		// -- PRIVATE METHODS
+		// ======================
+
+		/// @brief Lex, parse and analyze source
+		void run();
 };
 
 #endif
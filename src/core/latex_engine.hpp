@@ -0,0 +1,120 @@
+#ifndef LATEX_ENGINE_HPP
+#define LATEX_ENGINE_HPP
+
+#include <string_view>
+#include <vector>
+
+#include "../sem_analyzer/semantic_analyzer.hpp"
+#include "../lexer/lexer.hpp"
+#include "../lexer/utility/source_map.hpp"
+#include "../parser/parser.hpp"
+
+// ======================
+// -- ENUMS / STRUCTS
+// ======================
+
+/// @brief Outcome of LatexEngine::process, valid until the next call on the same engine
+struct LatexView
+{
+	const TokenStream *tokens = nullptr;               // const TokenStream*: Tokens of the text
+	ASTNode *root = nullptr;                           // ASTNode*: Root of the AST, nullptr on a parse error or empty text
+	Diagnostic parse_error;                            // Diagnostic: DiagnosticCode::NONE if the text parsed
+	const std::vector<SemanticError> *errors = nullptr; // const std::vector*: Semantic errors, empty on a parse error
+
+	/// @brief Check if the text parsed and analyzed without errors
+	/// @return True on success
+	bool ok() const { return parse_error.code == DiagnosticCode::NONE && errors->empty(); }
+};
+
+// ======================
+// -- LatexEngine
+// ======================
+
+/// @brief Long-lived lexer, parser and analyzer for many small texts
+/// @note Token, AST and error storage is reset and reused between calls, steady-state calls do not allocate
+class LatexEngine
+{
+	private:
+		// ======================
+		// -- ENGINE DATA
+		// ======================
+
+		Lexer lexer;
+		TokenStream tokens;
+		Parser parser;
+		SemanticAnalyzer analyzer;
+
+	public:
+		// ======================
+		// -- CONSTRUCTOR
+		// ======================
+
+		/// @brief Engine Constructor
+		/// @param kernel: The character-class scanning kernel, AUTO picks by CPU feature
+		explicit LatexEngine(CharScan::Kernel kernel = CharScan::Kernel::AUTO) : lexer(std::string_view(), kernel)
+		{
+			parser.set_scan_kernel(kernel);
+		}
+
+		// ======================
+		// -- MISC
+		// ======================
+
+		/// @brief Prevent copies, views point into the engine
+		LatexEngine(const LatexEngine &) = delete;
+
+		/// @brief Prevent copies, views point into the engine
+		/// @return LatexEngine
+		LatexEngine &operator=(const LatexEngine &) = delete;
+
+		// ======================
+		// -- PUBLIC METHODS
+		// ======================
+
+		/// @brief Lex, parse and analyze a text
+		/// @param text: The text to process, borrowed (not copied)
+		/// @param rules: Semantic rules to run, e.g. RuleSets::SYNTAX for a quick check
+		/// @return LatexView, valid until the next call
+		/// @note text must outlive the returned view, tokens point into it
+		/// @throws std::length_error if the text is 4 GiB or larger
+		LatexView process(std::string_view text, RuleSet rules = RuleSets::DEFAULT);
+
+		/// @brief Lex a text, then parse and analyze it in one pass without keeping the AST
+		/// @param text: The text to process, borrowed (not copied)
+		/// @param rules: Semantic rules to run, e.g. RuleSets::SYNTAX for a quick check
+		/// @return LatexView with a nullptr root and the same diagnostics process() reports, valid until the next call
+		/// @note Each node is checked as the parser builds it, there is no second walk over the tree
+		/// @throws std::length_error if the text is 4 GiB or larger
+		LatexView validate(std::string_view text, RuleSet rules = RuleSets::DEFAULT);
+
+		/// @brief Line and column of a byte offset in the last processed text
+		/// @param offset: Byte offset, e.g. Diagnostic::offset
+		/// @return SourceLocation
+		SourceLocation locate(uint32_t offset) const { return parser.source_map().locate(offset); }
+
+		/// @brief Limit how deeply the parser lets expressions nest, see Parser::set_max_depth
+		/// @param depth: Deepest nesting, deeper input fails with NESTING_TOO_DEEP
+		void set_max_depth(uint32_t depth) { parser.set_max_depth(depth); }
+
+		/// @brief Time every semantic rule call, see rule_stats
+		/// @param enabled: True to fill RuleStats::nanoseconds
+		void set_rule_profiling(bool enabled) { analyzer.set_profiling(enabled); }
+
+		/// @brief Counters of a semantic rule over every text processed since the last reset_rule_stats
+		/// @param rule: The rule
+		/// @return const RuleStats&
+		const RuleStats &rule_stats(SemanticRule rule) const { return analyzer.rule_stats(rule); }
+
+		/// @brief Zero the counters of every semantic rule
+		void reset_rule_stats() { analyzer.reset_rule_stats(); }
+
+		/// @brief Names of the variables of every text processed since the table was last cleared, see SemanticRule::VARIABLES
+		/// @return const SymbolTable&, cleared only once it passes SymbolTable::RETAIN_LIMIT
+		const SymbolTable &symbols() const { return parser.symbols(); }
+
+		/// @brief Memory usage of the AST arena
+		/// @return ASTArena::ArenaStats
+		ASTArena::ArenaStats arena_stats() const { return parser.arena_stats(); }
+};
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef LATEX_PIPELINE_HPP
+#define LATEX_PIPELINE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "./latex_batch.hpp"
+#include "./utility/spsc_queue.hpp"
+
+// ======================
+// -- ENUMS / STRUCTS
+// ======================
+
+struct PipelineOptions
+{
+	size_t depth = 8;                  // size_t: # of batches in flight between the stages
+	size_t batch_size = 16;            // size_t: Texts handed from stage to stage at a time
+	RuleSet rules = RuleSets::DEFAULT; // RuleSet: Semantic rules run on every text
+};
+
+// ======================
+// -- LatexPipeline
+// ======================
+
+/// @brief Lexes, parses and analyzes a stream of texts as three overlapping stages
+/// @note The caller's thread lexes, a parser thread and an analyzer thread run the other stages.
+///       Stages pass batches through SpscQueue, a stage that runs ahead blocks once depth batches are in flight.
+///       A blocked stage backs off from spinning to yielding to sleeping, see SpscQueue::backoff
+class LatexPipeline
+{
+	private:
+		// ======================
+		// -- PIPELINE DATA
+		// ======================
+
+		static constexpr uint32_t END_OF_STREAM = UINT32_MAX;
+
+		/// @brief Token buffers and parsers of one batch, recycled once the analyzer is done with it
+		struct Slot
+		{
+			size_t first = 0;                  // size_t: Index of the first text in the batch
+			size_t count = 0;                  // size_t: # of texts in the batch
+			std::vector<TokenStream> tokens;   // std::vector: Tokens per text
+			std::unique_ptr<Parser[]> parsers; // std::unique_ptr: Parser (and AST arena) per text
+			std::vector<ParseResult> parsed;   // std::vector: Parse outcome per text
+		};
+
+		PipelineOptions options;
+		std::vector<Slot> slots;  // std::vector: depth batches
+		Lexer lexer;
+		SemanticAnalyzer analyzer;
+
+		SpscQueue<uint32_t> lexed;    // SpscQueue: Lexer -> parser
+		SpscQueue<uint32_t> analyzed; // SpscQueue: Parser -> analyzer
+		SpscQueue<uint32_t> recycled; // SpscQueue: Analyzer -> lexer
+
+		/// @brief Parser stage, runs on its own thread
+		void parse_stage();
+
+		/// @brief Analyzer stage, runs on its own thread
+		/// @param visitor: Called per text in input order
+		/// @param failure: Receives the first exception thrown by visitor
+		void analyze_stage(const BatchVisitor &visitor, std::exception_ptr &failure);
+
+	public:
+		// ======================
+		// -- CONSTRUCTOR
+		// ======================
+
+		/// @brief Allocate the in-flight batches
+		/// @param opts: Depth, batch size and semantic rules
+		explicit LatexPipeline(PipelineOptions opts = {});
+
+		// ======================
+		// -- PUBLIC METHODS
+		// ======================
+
+		/// @brief Lex, parse and analyze every text through the pipeline
+		/// @param texts: First text, borrowed (not copied)
+		/// @param count: # of texts
+		/// @return One BatchItem per text, in input order
+		/// @throws std::length_error if a text is 4 GiB or larger
+		std::vector<BatchItem> process_stream(const std::string_view *texts, size_t count);
+
+		/// @brief Lex, parse and analyze every text through the pipeline, handing each view to a visitor
+		/// @param texts: First text, borrowed (not copied)
+		/// @param count: # of texts
+		/// @param visitor: Called on the analyzer thread in input order, the view is only valid during the call
+		/// @throws std::length_error if a text is 4 GiB or larger, or whatever visitor throws
+		void process_stream(const std::string_view *texts, size_t count, const BatchVisitor &visitor);
+};
+
+#endif
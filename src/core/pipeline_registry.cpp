@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <thread>
+
+#include "./latex_pipeline.hpp"
+
+// ======================
+// -- INIT
+// ======================
+
+/// @brief Allocate the in-flight batches
+/// @param opts: Depth, batch size and semantic rules
+LatexPipeline::LatexPipeline(PipelineOptions opts)
+	: options{std::max<size_t>(1, opts.depth), std::max<size_t>(1, opts.batch_size), opts.rules},
+	slots(options.depth),
+	lexer(std::string_view()),
+	analyzer(options.rules),
+	lexed(options.depth),
+	analyzed(options.depth),
+	recycled(options.depth)
+{
+	for (Slot &slot : slots)
+	{
+		slot.tokens.resize(options.batch_size);
+		slot.parsers.reset(new Parser[options.batch_size]);
+		slot.parsed.resize(options.batch_size);
+	}
+}
+
+// ======================
+// -- STAGES
+// ======================
+
+/// @brief Parser stage, runs on its own thread
+void LatexPipeline::parse_stage()
+{
+	for (uint32_t index = lexed.pop(); index != END_OF_STREAM; index = lexed.pop())
+	{
+		Slot &slot = slots[index];
+
+		for (size_t i = 0; i < slot.count; i++)
+		{
+			slot.parsers[i].reset(slot.tokens[i]);
+			slot.parsed[i] = slot.parsers[i].try_parse();
+		}
+
+		analyzed.push(index);
+	}
+
+	analyzed.push(END_OF_STREAM);
+}
+
+/// @brief Analyzer stage, runs on its own thread
+/// @param visitor: Called per text in input order
+/// @param failure: Receives the first exception thrown by visitor
+void LatexPipeline::analyze_stage(const BatchVisitor &visitor, std::exception_ptr &failure)
+{
+	for (uint32_t index = analyzed.pop(); index != END_OF_STREAM; index = analyzed.pop())
+	{
+		Slot &slot = slots[index];
+
+		for (size_t i = 0; i < slot.count && !failure; i++)
+		{
+			ParseResult &parsed = slot.parsed[i];
+
+			if (parsed.ok())
+				analyzer.analyze(parsed.root);
+			else
+				analyzer.clear();
+
+			try
+			{
+				visitor(slot.first + i, {&slot.tokens[i], parsed.root, parsed.error, &analyzer.get_errors()});
+			}
+			catch (...)
+			{
+				failure = std::current_exception();
+			}
+		}
+
+		recycled.push(index);
+	}
+}
+
+// ======================
+// -- PUBLIC METHODS
+// ======================
+
+/// @brief Lex, parse and analyze every text through the pipeline
+/// @param texts: First text, borrowed (not copied)
+/// @param count: # of texts
+/// @return One BatchItem per text, in input order
+/// @throws std::length_error if a text is 4 GiB or larger
+std::vector<BatchItem> LatexPipeline::process_stream(const std::string_view *texts, size_t count)
+{
+	std::vector<BatchItem> items(count);
+
+	process_stream(texts, count, [&items](size_t index, const LatexView &view) {
+			BatchItem &item = items[index];
+			item.parse_error = view.parse_error;
+			item.errors.assign(view.errors->begin(), view.errors->end());
+			item.token_count = static_cast<uint32_t>(view.tokens->size());
+			});
+
+	return items;
+}
+
+/// @brief Lex, parse and analyze every text through the pipeline, handing each view to a visitor
+/// @param texts: First text, borrowed (not copied)
+/// @param count: # of texts
+/// @param visitor: Called on the analyzer thread in input order, the view is only valid during the call
+/// @throws std::length_error if a text is 4 GiB or larger, or whatever visitor throws
+void LatexPipeline::process_stream(const std::string_view *texts, size_t count, const BatchVisitor &visitor)
+{
+	std::exception_ptr visitor_failure;
+	std::exception_ptr lexer_failure;
+
+	std::thread parser_thread(&LatexPipeline::parse_stage, this);
+	std::thread analyzer_thread(&LatexPipeline::analyze_stage, this, std::cref(visitor), std::ref(visitor_failure));
+
+	// The lexer stage runs here, fresh slots first, then whatever the analyzer hands back
+	size_t fresh = 0;
+
+	try
+	{
+		for (size_t first = 0; first < count; first += options.batch_size)
+		{
+			uint32_t index;
+
+			if (fresh < slots.size())
+			{
+				index = static_cast<uint32_t>(fresh++);
+			}
+			else
+			{
+				index = recycled.pop();
+			}
+
+			Slot &slot = slots[index];
+			slot.first = first;
+			slot.count = std::min(options.batch_size, count - first);
+
+			for (size_t i = 0; i < slot.count; i++)
+			{
+				lexer.reset(texts[first + i]);
+				lexer.tokenize(slot.tokens[i]);
+			}
+
+			lexed.push(index);
+		}
+	}
+	catch (...)
+	{
+		lexer_failure = std::current_exception();
+	}
+
+	lexed.push(END_OF_STREAM);
+	parser_thread.join();
+	analyzer_thread.join();
+
+	// Drain the slots the analyzer returned after the last pop, the ring must be empty for the next stream
+	uint32_t index;
+
+	while (recycled.try_pop(index))
+		continue;
+
+	if (lexer_failure)
+		std::rethrow_exception(lexer_failure);
+
+	if (visitor_failure)
+		std::rethrow_exception(visitor_failure);
+}
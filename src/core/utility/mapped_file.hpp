@@ -0,0 +1,78 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// ======================
+// -- MappedFile
+// ======================
+
+/// @brief Read-only memory mapping of a whole file
+/// @note Falls back to reading the file into a buffer where mmap is unavailable
+class MappedFile
+{
+	public:
+		// ======================
+		// -- CONSTRUCTOR
+		// ======================
+
+		/// @brief Empty mapping
+		MappedFile() = default;
+
+		/// @brief Map a file for sequential reading
+		/// @param path: Path of the file to map
+		/// @throws std::runtime_error if the file cannot be opened or mapped
+		explicit MappedFile(const std::string &path);
+
+		/// @brief Unmap the file
+		~MappedFile();
+
+		// ======================
+		// -- MISC
+		// ======================
+
+		/// @brief Prevent copies, the mapping is owned
+		MappedFile(const MappedFile &) = delete;
+
+		/// @brief Prevent copies, the mapping is owned
+		/// @return MappedFile
+		MappedFile &operator=(const MappedFile &) = delete;
+
+		/// @brief Take ownership of another mapping
+		/// @param other: The mapping to move from, left empty
+		MappedFile(MappedFile &&other) noexcept;
+
+		/// @brief Take ownership of another mapping
+		/// @param other: The mapping to move from, left empty
+		/// @return MappedFile
+		MappedFile &operator=(MappedFile &&other) noexcept;
+
+		// ======================
+		// -- PUBLIC METHODS
+		// ======================
+
+		/// @brief The mapped bytes
+		/// @return std::string_view, valid while this MappedFile is alive
+		std::string_view view() const { return std::string_view(data, length); }
+
+		/// @brief Size of the file in bytes
+		/// @return size_t
+		size_t size() const { return length; }
+
+	private:
+		// ======================
+		// -- PRIVATE DATA
+		// ======================
+
+		const char *data = nullptr; // const char*: Start of the mapping (or of fallback)
+		size_t length = 0;          // size_t: # of mapped bytes
+		bool mapped = false;        // bool: True if data must be unmapped rather than freed
+		std::string fallback;       // std::string: Buffer used when the file is read instead of mapped
+
+		/// @brief Release the mapping and leave this MappedFile empty
+		void release() noexcept;
+};
+
+#endif
@@ -0,0 +1,126 @@
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "./mapped_file.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILE_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ======================
+// -- INIT
+// ======================
+
+/// @brief Map a file for sequential reading
+/// @param path: Path of the file to map
+/// @throws std::runtime_error if the file cannot be opened or mapped
+MappedFile::MappedFile(const std::string &path)
+{
+#ifdef MAPPED_FILE_POSIX
+	int fd = ::open(path.c_str(), O_RDONLY);
+
+	if (fd < 0)
+		throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+
+	struct stat info;
+
+	if (::fstat(fd, &info) != 0)
+	{
+		int err = errno;
+		::close(fd);
+		throw std::runtime_error("Cannot stat " + path + ": " + std::strerror(err));
+	}
+
+	length = static_cast<size_t>(info.st_size);
+
+	// mmap rejects empty mappings, an empty file is an empty view
+	if (length == 0)
+	{
+		::close(fd);
+		return;
+	}
+
+	void *addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	int err = errno;
+	::close(fd);
+
+	if (addr == MAP_FAILED)
+	{
+		length = 0;
+		throw std::runtime_error("Cannot map " + path + ": " + std::strerror(err));
+	}
+
+	// The lexer reads front to back once, let the kernel read ahead and drop pages behind it
+	::madvise(addr, length, MADV_SEQUENTIAL);
+
+	data = static_cast<const char *>(addr);
+	mapped = true;
+#else
+	std::ifstream file(path, std::ios::binary);
+
+	if (!file)
+		throw std::runtime_error("Cannot open " + path);
+
+	fallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	data = fallback.data();
+	length = fallback.size();
+#endif
+}
+
+/// @brief Unmap the file
+MappedFile::~MappedFile()
+{
+	release();
+}
+
+/// @brief Take ownership of another mapping
+/// @param other: The mapping to move from, left empty
+MappedFile::MappedFile(MappedFile &&other) noexcept
+{
+	*this = std::move(other);
+}
+
+/// @brief Take ownership of another mapping
+/// @param other: The mapping to move from, left empty
+/// @return MappedFile
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+	if (this == &other)
+		return *this;
+
+	release();
+
+	mapped = std::exchange(other.mapped, false);
+	length = std::exchange(other.length, 0);
+	fallback = std::move(other.fallback);
+	data = mapped ? std::exchange(other.data, nullptr) : fallback.data();
+	other.data = nullptr;
+
+	return *this;
+}
+
+// ======================
+// -- PRIVATE METHODS
+// ======================
+
+/// @brief Release the mapping and leave this MappedFile empty
+void MappedFile::release() noexcept
+{
+#ifdef MAPPED_FILE_POSIX
+	if (mapped)
+		::munmap(const_cast<char *>(data), length);
+#endif
+
+	data = nullptr;
+	length = 0;
+	mapped = false;
+	fallback.clear();
+}
@@ -0,0 +1,148 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ======================
+// -- SpscQueue
+// ======================
+
+/// @brief Bounded lock-free ring buffer for exactly one producer thread and one consumer thread
+/// @tparam T Trivially copyable element type
+template <typename T>
+class SpscQueue
+{
+	static_assert(std::is_trivially_copyable_v<T>, "SpscQueue elements are copied through the ring");
+
+	private:
+		// ======================
+		// -- QUEUE DATA
+		// ======================
+
+		static constexpr size_t CACHE_LINE = 64;
+		static constexpr uint32_t SPIN_ATTEMPTS = 64;   // uint32_t: Failed attempts retried at once
+		static constexpr uint32_t YIELD_ATTEMPTS = 256; // uint32_t: Failed attempts, spins included, before sleeping
+		static constexpr std::chrono::microseconds SLEEP_TIME{50}; // std::chrono::microseconds: Sleep per attempt after that
+
+		std::vector<T> ring;                    // std::vector: Power-of-two ring of slots
+		size_t mask;                            // size_t: ring.size() - 1
+		alignas(CACHE_LINE) std::atomic<size_t> head{0}; // std::atomic: Next slot to pop, written by the consumer
+		alignas(CACHE_LINE) std::atomic<size_t> tail{0}; // std::atomic: Next slot to push, written by the producer
+
+		/// @brief Wait before retrying a failed push or pop
+		/// @param attempts: Failed attempts so far, counted up here
+		/// @note A short wait is retried at once, a longer one yields, an idle stage then sleeps instead of
+		///       keeping a core busy, at the cost of up to SLEEP_TIME of latency once work arrives
+		static void backoff(uint32_t &attempts)
+		{
+			if (attempts < SPIN_ATTEMPTS)
+			{
+				attempts++;
+			}
+			else if (attempts < YIELD_ATTEMPTS)
+			{
+				attempts++;
+				std::this_thread::yield();
+			}
+			else
+			{
+				std::this_thread::sleep_for(SLEEP_TIME);
+			}
+		}
+
+	public:
+		// ======================
+		// -- CONSTRUCTOR
+		// ======================
+
+		/// @brief Construct an empty queue
+		/// @param capacity: Most elements in flight, rounded up to a power of two
+		explicit SpscQueue(size_t capacity)
+		{
+			size_t size = 2;
+
+			while (size < capacity)
+				size <<= 1;
+
+			ring.resize(size);
+			mask = size - 1;
+		}
+
+		/// @brief Prevent copies, the indices are shared between two threads
+		SpscQueue(const SpscQueue &) = delete;
+
+		/// @brief Prevent copies, the indices are shared between two threads
+		/// @return SpscQueue
+		SpscQueue &operator=(const SpscQueue &) = delete;
+
+		// ======================
+		// -- PRODUCER
+		// ======================
+
+		/// @brief Push without waiting
+		/// @param value: Element to push
+		/// @return False if the queue is full
+		bool try_push(const T &value)
+		{
+			size_t t = tail.load(std::memory_order_relaxed);
+
+			if (t - head.load(std::memory_order_acquire) > mask)
+				return false;
+
+			ring[t & mask] = value;
+			tail.store(t + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		/// @brief Push, backing off while the queue is full (backpressure)
+		/// @param value: Element to push
+		void push(const T &value)
+		{
+			uint32_t attempts = 0;
+
+			while (!try_push(value))
+				backoff(attempts);
+		}
+
+		// ======================
+		// -- CONSUMER
+		// ======================
+
+		/// @brief Pop without waiting
+		/// @param value: Receives the popped element
+		/// @return False if the queue is empty
+		bool try_pop(T &value)
+		{
+			size_t h = head.load(std::memory_order_relaxed);
+
+			if (h == tail.load(std::memory_order_acquire))
+				return false;
+
+			value = ring[h & mask];
+			head.store(h + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		/// @brief Pop, backing off while the queue is empty
+		/// @return The popped element
+		T pop()
+		{
+			T value;
+			uint32_t attempts = 0;
+
+			while (!try_pop(value))
+				backoff(attempts);
+
+			return value;
+		}
+};
+
+#endif
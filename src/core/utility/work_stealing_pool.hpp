@@ -0,0 +1,114 @@
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ======================
+// -- WorkStealingPool
+// ======================
+
+/// @brief Fixed set of worker threads running index ranges, idle workers steal half of a busy worker's range
+/// @note The calling thread joins in as worker 0, so a pool of 1 runs everything inline
+class WorkStealingPool
+{
+	public:
+		using RangeTask = std::function<void(size_t worker, size_t begin, size_t end)>;
+
+	private:
+		// ======================
+		// -- POOL DATA
+		// ======================
+
+		/// @brief Indices a worker has not run yet, guarded by its own mutex
+		struct WorkerRange
+		{
+			std::mutex mutex;
+			size_t next = 0;
+			size_t end = 0;
+		};
+
+		std::vector<std::thread> threads;                  // std::vector: Background workers 1..size()-1
+		std::vector<std::unique_ptr<WorkerRange>> ranges;  // std::vector: Pending indices per worker
+
+		std::mutex mutex;                    // std::mutex: Guards the job fields below
+		std::condition_variable job_ready;   // std::condition_variable: Signals a new generation or shutdown
+		std::condition_variable job_done;    // std::condition_variable: Signals the last worker finished
+		const RangeTask *task = nullptr;     // const RangeTask*: Body of the current job
+		size_t chunk = 1;                    // size_t: Indices claimed at a time
+		size_t generation = 0;               // size_t: Bumped for every job
+		size_t running = 0;                  // size_t: Background workers still on the current job
+		bool stopping = false;               // bool: Set by the destructor
+		std::exception_ptr failure;          // std::exception_ptr: First exception thrown by the task
+
+		/// @brief Background worker loop
+		/// @param worker: Index of the worker
+		void worker_main(size_t worker);
+
+		/// @brief Run ranges until no worker has any left
+		/// @param worker: Index of the worker
+		void run_ranges(size_t worker);
+
+		/// @brief Claim the next chunk from a worker's own range
+		/// @param worker: Index of the worker
+		/// @param begin: First claimed index
+		/// @param end: One past the last claimed index
+		/// @return True if anything was claimed
+		bool claim(size_t worker, size_t &begin, size_t &end);
+
+		/// @brief Move the back half of another worker's range to this worker
+		/// @param worker: Index of the thief
+		/// @return True if anything was stolen
+		bool steal(size_t worker);
+
+	public:
+		// ======================
+		// -- CONSTRUCTOR
+		// ======================
+
+		/// @brief Start the worker threads
+		/// @param thread_count: # of workers including the caller, 0 for std::thread::hardware_concurrency
+		explicit WorkStealingPool(size_t thread_count = 0);
+
+		// ======================
+		// -- DESTRUCTOR
+		// ======================
+
+		/// @brief Stop and join the worker threads
+		~WorkStealingPool();
+
+		// ======================
+		// -- MISC
+		// ======================
+
+		/// @brief Prevent copies, the threads are owned
+		WorkStealingPool(const WorkStealingPool &) = delete;
+
+		/// @brief Prevent copies, the threads are owned
+		/// @return WorkStealingPool
+		WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+		// ======================
+		// -- PUBLIC METHODS
+		// ======================
+
+		/// @brief # of workers including the caller
+		/// @return size_t
+		size_t size() const { return ranges.size(); }
+
+		/// @brief Run a task over [0, count) in chunks and wait for it
+		/// @param count: # of indices
+		/// @param chunk_size: Indices claimed at a time, at least 1
+		/// @param body: Called with (worker, begin, end), concurrently from different workers
+		/// @throws The first exception thrown by body, after every worker has stopped
+		/// @note One parallel_for at a time per pool
+		void parallel_for(size_t count, size_t chunk_size, const RangeTask &body);
+};
+
+#endif
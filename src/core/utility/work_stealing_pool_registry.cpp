@@ -0,0 +1,199 @@
+#include <algorithm>
+
+#include "./work_stealing_pool.hpp"
+
+// ======================
+// -- INIT
+// ======================
+
+/// @brief Start the worker threads
+/// @param thread_count: # of workers including the caller, 0 for std::thread::hardware_concurrency
+WorkStealingPool::WorkStealingPool(size_t thread_count)
+{
+	if (thread_count == 0)
+		thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+	for (size_t i = 0; i < thread_count; i++)
+		ranges.push_back(std::make_unique<WorkerRange>());
+
+	threads.reserve(thread_count - 1);
+
+	for (size_t i = 1; i < thread_count; i++)
+		threads.emplace_back(&WorkStealingPool::worker_main, this, i);
+}
+
+/// @brief Stop and join the worker threads
+WorkStealingPool::~WorkStealingPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+
+	job_ready.notify_all();
+
+	for (auto &thread : threads)
+		thread.join();
+}
+
+// ======================
+// -- WORKER IMPL.
+// ======================
+
+/// @brief Background worker loop
+/// @param worker: Index of the worker
+void WorkStealingPool::worker_main(size_t worker)
+{
+	size_t seen = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			job_ready.wait(lock, [&] { return stopping || generation != seen; });
+
+			if (stopping)
+				return;
+
+			seen = generation;
+		}
+
+		run_ranges(worker);
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (--running == 0)
+			job_done.notify_one();
+	}
+}
+
+/// @brief Run ranges until no worker has any left
+/// @param worker: Index of the worker
+void WorkStealingPool::run_ranges(size_t worker)
+{
+	size_t begin;
+	size_t end;
+
+	while (claim(worker, begin, end) || (steal(worker) && claim(worker, begin, end)))
+	{
+		try
+		{
+			(*task)(worker, begin, end);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (!failure)
+				failure = std::current_exception();
+		}
+	}
+}
+
+/// @brief Claim the next chunk from a worker's own range
+/// @param worker: Index of the worker
+/// @param begin: First claimed index
+/// @param end: One past the last claimed index
+/// @return True if anything was claimed
+bool WorkStealingPool::claim(size_t worker, size_t &begin, size_t &end)
+{
+	WorkerRange &range = *ranges[worker];
+	std::lock_guard<std::mutex> lock(range.mutex);
+
+	if (range.next >= range.end)
+		return false;
+
+	begin = range.next;
+	end = std::min(range.end, begin + chunk);
+	range.next = end;
+
+	return true;
+}
+
+/// @brief Move the back half of another worker's range to this worker
+/// @param worker: Index of the thief
+/// @return True if anything was stolen
+bool WorkStealingPool::steal(size_t worker)
+{
+	for (size_t i = 1; i < ranges.size(); i++)
+	{
+		WorkerRange &victim = *ranges[(worker + i) % ranges.size()];
+		size_t begin;
+		size_t end;
+
+		{
+			std::lock_guard<std::mutex> lock(victim.mutex);
+
+			if (victim.next >= victim.end)
+				continue;
+
+			// Leave the victim at least the chunk it would claim next
+			size_t remaining = victim.end - victim.next;
+			size_t taken = remaining > chunk ? remaining / 2 : remaining;
+
+			end = victim.end;
+			begin = end - taken;
+			victim.end = begin;
+		}
+
+		WorkerRange &own = *ranges[worker];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		own.next = begin;
+		own.end = end;
+
+		return true;
+	}
+
+	return false;
+}
+
+// ======================
+// -- PUBLIC METHODS
+// ======================
+
+/// @brief Run a task over [0, count) in chunks and wait for it
+/// @param count: # of indices
+/// @param chunk_size: Indices claimed at a time, at least 1
+/// @param body: Called with (worker, begin, end), concurrently from different workers
+/// @throws The first exception thrown by body, after every worker has stopped
+void WorkStealingPool::parallel_for(size_t count, size_t chunk_size, const RangeTask &body)
+{
+	if (count == 0)
+		return;
+
+	// Contiguous slices keep neighbouring inputs on one worker until someone runs dry
+	size_t workers = ranges.size();
+
+	for (size_t i = 0; i < workers; i++)
+	{
+		WorkerRange &range = *ranges[i];
+		std::lock_guard<std::mutex> lock(range.mutex);
+		range.next = count * i / workers;
+		range.end = count * (i + 1) / workers;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		task = &body;
+		chunk = std::max<size_t>(1, chunk_size);
+		failure = nullptr;
+		running = threads.size();
+		generation++;
+	}
+
+	job_ready.notify_all();
+	run_ranges(0);
+
+	std::exception_ptr thrown;
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		job_done.wait(lock, [&] { return running == 0; });
+
+		task = nullptr;
+		thrown = failure;
+	}
+
+	if (thrown)
+		std::rethrow_exception(thrown);
+}
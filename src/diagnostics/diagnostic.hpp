@@ -0,0 +1,86 @@
+#ifndef DIAGNOSTIC_HPP
+#define DIAGNOSTIC_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../lexer/token_stream.hpp"
+#include "../lexer/utility/source_map.hpp"
+
+// ======================
+// -- ENUMS / STRUCTS
+// ======================
+
+enum class DiagnosticCode : uint8_t
+{
+	NONE,
+
+	// PARSER, operands[0] is the token index
+	UNEXPECTED_TOKEN,            // operands[1]: expected TokenType
+	MISSING_OPTIONAL_CLOSE,      // ']' after an optional argument
+	MISSING_ARGUMENT_CLOSE,      // '}' after a mandatory argument
+	MISSING_CALL_CLOSE,          // ')' after function arguments
+	MISSING_ESCAPED_GROUP_CLOSE, // '\}' after an escaped group
+	MISSING_GROUP_CLOSE,         // '}' after a group
+	TRAILING_TOKEN,
+	UNEXPECTED_PRIMARY,
+	INVALID_NUMBER,
+	MISMATCHED_ENVIRONMENT,      // operands[0]: the \begin token
+	MISSING_RIGHT,               // operands[1]: the \left token
+	BRACES_REQUIRED,             // operands[0]: the command token
+	DUPLICATE_SCRIPT,
+	NESTING_TOO_DEEP,            // operands[1]: the nesting limit
+
+	// SEMANTIC, operands[0] is the offset of the offending operand
+	EMPTY_AST,
+	INVALID_NUMBER_VALUE,
+	ASSIGN_TO_LITERAL,
+	DIVISION_BY_ZERO,
+	SQRT_OF_NEGATIVE,
+	LOG_OF_NON_POSITIVE,
+	LOG_OF_NEGATIVE,
+	INVERSE_TRIG_DOMAIN,
+	TRIG_POLE,
+	INVALID_BINOMIAL,
+	USE_BEFORE_DEFINITION,       // operands[1]: the SymbolId, see SemanticRule::VARIABLES
+	UNUSED_VARIABLE,             // operands[1]: the SymbolId, see SemanticRule::VARIABLES
+
+	COUNT
+};
+
+/// @brief A parse or semantic problem, no text is stored
+/// @note Trivially copyable, render_diagnostic builds the message on demand
+struct Diagnostic
+{
+	DiagnosticCode code = DiagnosticCode::NONE; // DiagnosticCode: What went wrong
+	uint32_t offset = 0;                        // uint32_t: Source byte offset, see SourceMap for line / column
+	uint32_t operands[2] = {0, 0};              // uint32_t[2]: Code specific token indices / offsets / types
+};
+
+using DiagnosticCounts = std::array<uint32_t, static_cast<size_t>(DiagnosticCode::COUNT)>;
+
+// ======================
+// -- PUBLIC METHODS
+// ======================
+
+/// @brief Fixed text of a code, without any operands
+/// @param code: The code
+/// @return std::string_view
+std::string_view diagnostic_text(DiagnosticCode code);
+
+/// @brief Render the full message of a diagnostic
+/// @param diagnostic: The diagnostic
+/// @param tokens: Tokens the parser read, operands of parse codes index into it
+/// @param map: Source map of the tokens' source
+/// @return std::string
+std::string render_diagnostic(const Diagnostic &diagnostic, const TokenStream &tokens, const SourceMap &map);
+
+/// @brief Count diagnostics by code
+/// @param diagnostics: The diagnostics
+/// @return DiagnosticCounts indexed by DiagnosticCode
+DiagnosticCounts count_diagnostics(const std::vector<Diagnostic> &diagnostics);
+
+#endif
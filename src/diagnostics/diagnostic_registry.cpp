@@ -0,0 +1,150 @@
+#include "./diagnostic.hpp"
+
+// ======================
+// -- INIT
+// ======================
+
+namespace
+{
+	/// @brief Quote a token with its type, e.g. 'x' (25)
+	/// @param token: The token
+	/// @return std::string
+	std::string token_repr(const Token &token)
+	{
+		return "'" + std::string(token.Value) + "' (" + std::to_string(static_cast<int>(token.Type)) + ")";
+	}
+
+	/// @brief Format a location suffix, e.g. " @1:7"
+	/// @param loc: The location
+	/// @return std::string
+	std::string at(SourceLocation loc)
+	{
+		return " @" + std::to_string(loc.line) + ':' + std::to_string(loc.column);
+	}
+}
+
+// ======================
+// -- METHODS
+// ======================
+
+/// @brief Fixed text of a code, without any operands
+/// @param code: The code
+/// @return std::string_view
+std::string_view diagnostic_text(DiagnosticCode code)
+{
+	switch (code)
+	{
+		case DiagnosticCode::NONE:
+			return "No error";
+		case DiagnosticCode::UNEXPECTED_TOKEN:
+			return "Expected Token Type";
+		case DiagnosticCode::MISSING_OPTIONAL_CLOSE:
+			return "Expected ']' after optional argument";
+		case DiagnosticCode::MISSING_ARGUMENT_CLOSE:
+			return "Expected '}' after mandatory argument";
+		case DiagnosticCode::MISSING_CALL_CLOSE:
+			return "Expected ')' after function arguments";
+		case DiagnosticCode::MISSING_ESCAPED_GROUP_CLOSE:
+			return "Expected '\\}' after escaped group";
+		case DiagnosticCode::MISSING_GROUP_CLOSE:
+			return "Expected '}' after group";
+		case DiagnosticCode::TRAILING_TOKEN:
+			return "Unexpected token after complete expression";
+		case DiagnosticCode::UNEXPECTED_PRIMARY:
+			return "Unexpected token in primary";
+		case DiagnosticCode::INVALID_NUMBER:
+			return "Invalid number";
+		case DiagnosticCode::MISMATCHED_ENVIRONMENT:
+			return "Mismatched environment closure";
+		case DiagnosticCode::MISSING_RIGHT:
+			return "Missing \\right to match \\left";
+		case DiagnosticCode::BRACES_REQUIRED:
+			return "Command requires braced arguments";
+		case DiagnosticCode::DUPLICATE_SCRIPT:
+			return "Multiple scripts of the same type detected";
+		case DiagnosticCode::NESTING_TOO_DEEP:
+			return "Expression nested too deeply";
+		case DiagnosticCode::EMPTY_AST:
+			return "Empty AST";
+		case DiagnosticCode::INVALID_NUMBER_VALUE:
+			return "Invalid number value";
+		case DiagnosticCode::ASSIGN_TO_LITERAL:
+			return "Cannot assign to a literal value";
+		case DiagnosticCode::DIVISION_BY_ZERO:
+			return "Division by zero";
+		case DiagnosticCode::SQRT_OF_NEGATIVE:
+			return "Square root of negative number (requires complex numbers)";
+		case DiagnosticCode::LOG_OF_NON_POSITIVE:
+			return "Logarithm of non-positive number is undefined";
+		case DiagnosticCode::LOG_OF_NEGATIVE:
+			return "Logarithm of negative number is undefined";
+		case DiagnosticCode::INVERSE_TRIG_DOMAIN:
+			return "Inverse sine or cosine of a number outside [-1, 1] is undefined";
+		case DiagnosticCode::TRIG_POLE:
+			return "Cosecant or cotangent of 0 is undefined";
+		case DiagnosticCode::INVALID_BINOMIAL:
+			return "Binomial coefficient of a negative or non-integer number";
+		case DiagnosticCode::USE_BEFORE_DEFINITION:
+			return "Variable used before its definition";
+		case DiagnosticCode::UNUSED_VARIABLE:
+			return "Variable is defined but never used";
+		case DiagnosticCode::COUNT:
+			break;
+	}
+
+	return "Unknown error";
+}
+
+/// @brief Render the full message of a diagnostic
+/// @param diagnostic: The diagnostic
+/// @param tokens: Tokens the parser read, operands of parse codes index into it
+/// @param map: Source map of the tokens' source
+/// @return std::string
+std::string render_diagnostic(const Diagnostic &diagnostic, const TokenStream &tokens, const SourceMap &map)
+{
+	DiagnosticCode code = diagnostic.code;
+
+	if (code < DiagnosticCode::UNEXPECTED_TOKEN || code > DiagnosticCode::NESTING_TOO_DEEP)
+		return std::string(diagnostic_text(code));
+
+	Token tok = tokens[diagnostic.operands[0]];
+
+	switch (code)
+	{
+		case DiagnosticCode::UNEXPECTED_TOKEN:
+			return "Expected Token Type: (" + std::to_string(diagnostic.operands[1]) + ") but found " + token_repr(tok);
+		case DiagnosticCode::MISSING_OPTIONAL_CLOSE:
+		case DiagnosticCode::MISSING_ARGUMENT_CLOSE:
+		case DiagnosticCode::MISSING_CALL_CLOSE:
+		case DiagnosticCode::MISSING_ESCAPED_GROUP_CLOSE:
+		case DiagnosticCode::MISSING_GROUP_CLOSE:
+			return std::string(diagnostic_text(code)) + " but found " + token_repr(tok);
+		case DiagnosticCode::TRAILING_TOKEN:
+			return "Unexpected token " + token_repr(tok) + " after complete expression" + at(map.locate(tok.offset));
+		case DiagnosticCode::UNEXPECTED_PRIMARY:
+			return "Unexpected token in primary: " + token_repr(tok) + at(map.locate(tok.offset));
+		case DiagnosticCode::INVALID_NUMBER:
+			return "Invalid number" + at(map.locate(tok.offset));
+		case DiagnosticCode::MISSING_RIGHT:
+			return std::string(diagnostic_text(code)) + at(map.locate(tokens.offsets[diagnostic.operands[1]]));
+		case DiagnosticCode::BRACES_REQUIRED:
+			return "Command '" + std::string(tok.Value) + "' requires braced arguments";
+		case DiagnosticCode::NESTING_TOO_DEEP:
+			return "Expression nested deeper than " + std::to_string(diagnostic.operands[1]) + " levels" + at(map.locate(tok.offset));
+		default:
+			return std::string(diagnostic_text(code));
+	}
+}
+
+/// @brief Count diagnostics by code
+/// @param diagnostics: The diagnostics
+/// @return DiagnosticCounts indexed by DiagnosticCode
+DiagnosticCounts count_diagnostics(const std::vector<Diagnostic> &diagnostics)
+{
+	DiagnosticCounts counts{};
+
+	for (const auto &diagnostic : diagnostics)
+		counts[static_cast<size_t>(diagnostic.code)]++;
+
+	return counts;
+}
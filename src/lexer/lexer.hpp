@@ -1,12 +1,11 @@
 #ifndef LEXER_HPP
 #define LEXER_HPP
 
-#include <vector>
-#include <string>
-#include <array>
-#include <functional>
+#include <string_view>
 
 #include "./token_info.hpp"
+#include "./token_stream.hpp"
+#include "./utility/char_scan.hpp"
 
 // ======================
 // -- LEXER
@@ -19,19 +18,10 @@ class Lexer
 		// -- LEXER DATA
 		// ======================
 
-		std::string input;
+		std::string_view input;
 		size_t position{0};
 
-		int line{1};
-		int column{1};
-
-		// ======================
-		// -- DISPATCH DATA
-		// ======================
-
-		using LexerAction = std::function<void(Lexer *, std::vector<Token> &)>;
-
-		static const std::array<LexerAction, 256> LEXER_DISPATCH_TABLE;
+		const CharScan::ScanKernel *scanner;
 
 		// ======================
 		// -- LEXER UTILITY
@@ -45,18 +35,22 @@ class Lexer
 		/// @return Current character before advancing, or '\0' if at end
 		char advance();
 
+		/// @brief Advance over a run
+		/// @param length: Length of the run
+		void advance_run(size_t length);
+
 		/// @brief Read a number
 		/// @param tokens: The current tokens
-		void handle_number(std::vector<Token> &tokens);
+		void handle_number(TokenStream &tokens);
 
 		/// @brief Handle a single character
 		/// @param tokens: The current tokens
 		/// @param type: Current token type
-		void handle_single_char(std::vector<Token> &tokens, TokenType type);
+		void handle_single_char(TokenStream &tokens, TokenType type);
 
 		/// @brief Read the current input
 		/// @param tokens: The current tokens
-		void handle_command(std::vector<Token> &tokens);
+		void handle_command(TokenStream &tokens);
 
 		// ======================
 		// -- DISPATCH METHODS
@@ -64,27 +58,34 @@ class Lexer
 
 		/// @brief DISPATCH: <
 		/// @param tokens: The current tokens
-		void handle_less(std::vector<Token> &tokens);
+		void handle_less(TokenStream &tokens);
 
 		/// @brief DISPATCH: >
 		/// @param tokens: The current tokens
-		void handle_greater(std::vector<Token> &tokens);
+		void handle_greater(TokenStream &tokens);
 
 		/// @brief DISPATCH: COMMENT
 		/// @param tokens: The current tokens
-		void handle_comment(std::vector<Token> &tokens);
+		void handle_comment(TokenStream &tokens);
 
 		/// @brief DISPATCH: WHITESPACE
 		/// @param tokens: The current tokens
-		void handle_whitespace(std::vector<Token> &tokens);
+		void handle_whitespace(TokenStream &tokens);
 
 		/// @brief DISPATCH: INVALID
 		/// @param tokens: The current tokens
-		void handle_invalid(std::vector<Token> &tokens);
+		void handle_invalid(TokenStream &tokens);
 
 		/// @brief DISPATCH: IDENTIFIER (variables like x, y, z)
 		/// @param tokens: The current tokens
-		void handle_identifier(std::vector<Token> &tokens);
+		void handle_identifier(TokenStream &tokens);
+
+		// ======================
+		// -- FRIENDS
+		// ======================
+
+		// Replays the std::function table tokenize() dispatched through before CharClassTable, see BM_LexerDispatch
+		friend class LexerReference;
 
 	public:
 		// ======================
@@ -92,16 +93,33 @@ class Lexer
 		// ======================
 
 		/// @brief Lexer Constructor
-		/// @param text: The text to put into the lexer
-		Lexer(std::string text) : input(std::move(text)) {}
+		/// @param text: The text to put into the lexer, borrowed (not copied)
+		/// @param kernel: The character-class scanning kernel, AUTO picks by CPU feature
+		/// @note text must outlive the lexer and every TokenStream it produces, offsets point into it
+		Lexer(std::string_view text, CharScan::Kernel kernel = CharScan::Kernel::AUTO)
+			: input(text), scanner(&CharScan::get_kernel(kernel)) {}
 
 		// ======================
 		// -- PUBLIC METHODS
 		// ======================
 
+		/// @brief Point the lexer at new text and rewind it
+		/// @param text: The text to put into the lexer, borrowed (not copied)
+		void reset(std::string_view text)
+		{
+			input = text;
+			position = 0;
+		}
+
 		/// @brief Tokenize the current input
-		/// @return std::vector<Token>
-		std::vector<Token> tokenize();
+		/// @return TokenStream, its source is the lexer's text
+		/// @throws std::length_error if the text is 4 GiB or larger
+		TokenStream tokenize();
+
+		/// @brief Tokenize the current input into an existing stream, reusing its capacity
+		/// @param tokens: Stream to overwrite, its source becomes the lexer's text
+		/// @throws std::length_error if the text is 4 GiB or larger
+		void tokenize(TokenStream &tokens);
 };
 
 #endif
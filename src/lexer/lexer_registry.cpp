@@ -1,8 +1,8 @@
 #include <cctype>
-#include <vector>
+#include <cstdint>
+#include <stdexcept>
 #include <string>
 #include <array>
-#include <functional>
 
 #include "./lexer.hpp"
 #include "./token_info.hpp"
@@ -12,79 +12,94 @@
 // -- INIT
 // ======================
 
-const std::array<Lexer::LexerAction, 256> Lexer::LEXER_DISPATCH_TABLE = []
+namespace
 {
-	std::array<Lexer::LexerAction, 256> table{};
-
-	for (int i = 0; i < 256; i++)
-		table[i] = [](Lexer *s, std::vector<Token> &t)
-		{ s->handle_invalid(t); };
-
-	auto map_char = [&](unsigned char c, TokenType type)
+	enum class CharClass : unsigned char
 	{
-		table[c] = [type](Lexer *self, std::vector<Token> &tokens)
-		{
-			self->handle_single_char(tokens, type);
-		};
+		INVALID,
+		DIGIT,
+		ALPHA,
+		WHITESPACE,
+		COMMAND,
+		LESS,
+		GREATER,
+		COMMENT,
+		SINGLE_CHAR
 	};
 
-	auto num = [](Lexer *s, std::vector<Token> &t)
-	{ s->handle_number(t); };
-	for (char c = '0'; c <= '9'; c++)
-		table[(unsigned char)c] = num;
-
-	auto ident = [](Lexer *s, std::vector<Token> &t)
-	{ s->handle_identifier(t); };
-	for (char c = 'a'; c <= 'z'; c++)
-		table[(unsigned char)c] = ident;
-	for (char c = 'A'; c <= 'Z'; c++)
-		table[(unsigned char)c] = ident;
-
-	table[(unsigned char)' '] = table[(unsigned char)'\t'] =
-		table[(unsigned char)'\n'] = [](Lexer *s, std::vector<Token> &t)
-		{ s->handle_whitespace(t); };
-
-	table[(unsigned char)'\\'] = [](Lexer *s, std::vector<Token> &t)
-	{ s->handle_command(t); };
-	table[(unsigned char)'<'] = [](Lexer *s, std::vector<Token> &t)
-	{ s->handle_less(t); };
-	table[(unsigned char)'>'] = [](Lexer *s, std::vector<Token> &t)
-	{ s->handle_greater(t); };
-	table[(unsigned char)'%'] = [](Lexer *s, std::vector<Token> &t)
-	{ s->handle_comment(t); };
-
-	map_char('{', TokenType::BRACE_OPEN);
-	map_char('}', TokenType::BRACE_CLOSE);
-
-	map_char('(', TokenType::PAREN_OPEN);
-	map_char(')', TokenType::PAREN_CLOSE);
-
-	map_char('[', TokenType::BRACKET_OPEN);
-	map_char(']', TokenType::BRACKET_CLOSE);
-
-	map_char('+', TokenType::PLUS);
-	map_char('-', TokenType::MINUS);
-	map_char('*', TokenType::STAR);
-	map_char('/', TokenType::SLASH);
-
-	map_char('^', TokenType::SUPERSCRIPT);
-	map_char('_', TokenType::SUBSCRIPT);
-	map_char('&', TokenType::ALIGNMENT);
-	map_char('$', TokenType::DOLLAR);
-
-	map_char('\'', TokenType::PUNCTUATION);
-	map_char('.', TokenType::PUNCTUATION);
-	map_char(':', TokenType::PUNCTUATION);
-	map_char(';', TokenType::PUNCTUATION);
-	map_char('?', TokenType::PUNCTUATION);
+	struct CharClassTable
+	{
+		std::array<CharClass, 256> classes{};
+		std::array<TokenType, 256> types{};
 
-	map_char(',', TokenType::SPACING);
+		constexpr CharClassTable()
+		{
+			for (int i = 0; i < 256; i++)
+			{
+				classes[i] = CharClass::INVALID;
+				types[i] = TokenType::INVALID;
+			}
+
+			for (char c = '0'; c <= '9'; c++)
+				classes[static_cast<unsigned char>(c)] = CharClass::DIGIT;
+
+			for (char c = 'a'; c <= 'z'; c++)
+				classes[static_cast<unsigned char>(c)] = CharClass::ALPHA;
+			for (char c = 'A'; c <= 'Z'; c++)
+				classes[static_cast<unsigned char>(c)] = CharClass::ALPHA;
+
+			classes[static_cast<unsigned char>(' ')] = CharClass::WHITESPACE;
+			classes[static_cast<unsigned char>('\t')] = CharClass::WHITESPACE;
+			classes[static_cast<unsigned char>('\n')] = CharClass::WHITESPACE;
+
+			classes[static_cast<unsigned char>('\\')] = CharClass::COMMAND;
+			classes[static_cast<unsigned char>('<')] = CharClass::LESS;
+			classes[static_cast<unsigned char>('>')] = CharClass::GREATER;
+			classes[static_cast<unsigned char>('%')] = CharClass::COMMENT;
+
+			map_char('{', TokenType::BRACE_OPEN);
+			map_char('}', TokenType::BRACE_CLOSE);
+
+			map_char('(', TokenType::PAREN_OPEN);
+			map_char(')', TokenType::PAREN_CLOSE);
+
+			map_char('[', TokenType::BRACKET_OPEN);
+			map_char(']', TokenType::BRACKET_CLOSE);
+
+			map_char('+', TokenType::PLUS);
+			map_char('-', TokenType::MINUS);
+			map_char('*', TokenType::STAR);
+			map_char('/', TokenType::SLASH);
+
+			map_char('^', TokenType::SUPERSCRIPT);
+			map_char('_', TokenType::SUBSCRIPT);
+			map_char('&', TokenType::ALIGNMENT);
+			map_char('$', TokenType::DOLLAR);
+
+			map_char('\'', TokenType::PUNCTUATION);
+			map_char('.', TokenType::PUNCTUATION);
+			map_char(':', TokenType::PUNCTUATION);
+			map_char(';', TokenType::PUNCTUATION);
+			map_char('?', TokenType::PUNCTUATION);
+
+			map_char(',', TokenType::SPACING);
+
+			map_char('=', TokenType::EQUAL);
+			map_char('!', TokenType::FACTORIAL);
+		}
 
-	map_char('=', TokenType::EQUAL);
-	map_char('!', TokenType::FACTORIAL);
+		/// @brief Map a character to a single character token
+		/// @param c: The character
+		/// @param type: The token type it produces
+		constexpr void map_char(unsigned char c, TokenType type)
+		{
+			classes[c] = CharClass::SINGLE_CHAR;
+			types[c] = type;
+		}
+	};
 
-	return table;
-}();
+	static constexpr CharClassTable CHAR_LOOKUP;
+}
 
 // ======================
 // -- METHODS
@@ -107,76 +122,50 @@ char Lexer::advance()
 	if (position >= input.size())
 		return '\0';
 
-	char current = input[position];
-	position++;
-
-	if (current == '\n')
-	{
-		line++;
-		column = 1;
-	}
-	else
-	{
-		column++;
-	}
+	return input[position++];
+}
 
-	return current;
+/// @brief Advance over a run
+/// @param length: Length of the run
+void Lexer::advance_run(size_t length)
+{
+	position += length;
 }
 
 /// @brief Read a number
 /// @param tokens: The current tokens
-void Lexer::handle_number(std::vector<Token> &tokens)
+void Lexer::handle_number(TokenStream &tokens)
 {
-	int start_line = line;
-	int start_column = column;
 	size_t start = position;
+	const char *end = input.data() + input.size();
 
-	while (std::isdigit(static_cast<unsigned char>(peek())))
-	{
-		advance();
-	}
+	advance_run(scanner->digit(input.data() + position, end));
 
 	if (peek() == '.')
 	{
 		advance();
-
-		while (std::isdigit(static_cast<unsigned char>(peek())))
-		{
-			advance();
-		}
+		advance_run(scanner->digit(input.data() + position, end));
 	}
 
-	tokens.push_back({std::string_view(input.data() + start, position - start),
-			nullptr,
-			TokenType::NUMBER,
-			start_line,
-			start_column});
+	tokens.push(start, position - start, TokenType::NUMBER, CommandId::NONE);
 }
 
 /// @brief Handle a single character
 /// @param tokens: The current tokens
 /// @param type: Current token type
-void Lexer::handle_single_char(std::vector<Token> &tokens, TokenType type)
+void Lexer::handle_single_char(TokenStream &tokens, TokenType type)
 {
-	int start_line = line;
-	int start_column = column;
 	size_t start = position;
 
 	advance();
 
-	tokens.push_back({std::string_view(input.data() + start, 1),
-			nullptr,
-			type,
-			start_line,
-			start_column});
+	tokens.push(start, 1, type, CommandId::NONE);
 }
 
 /// @brief Read the current input
 /// @param tokens: The current tokens
-void Lexer::handle_command(std::vector<Token> &tokens)
+void Lexer::handle_command(TokenStream &tokens)
 {
-	int start_line = line;
-	int start_column = column;
 	size_t start_pos = position;
 
 	advance();
@@ -189,76 +178,65 @@ void Lexer::handle_command(std::vector<Token> &tokens)
 		std::string_view cmd(input.data() + start_pos, position - start_pos);
 
 		if (const CommandInfo *info = LatexParser::find_command(cmd))
-			tokens.push_back({cmd, info, info->type_override, start_line, start_column});
+			tokens.push(start_pos, cmd.size(), info->type_override, info->id);
 		else
-			tokens.push_back({cmd, nullptr, TokenType::COMMAND, start_line, start_column});
+			tokens.push(start_pos, cmd.size(), TokenType::COMMAND, CommandId::NONE);
 
 		return;
 	}
 
-	while (std::isalpha(static_cast<unsigned char>(peek())))
-		advance();
+	advance_run(scanner->alpha(input.data() + position, input.data() + input.size()));
 
 	std::string_view cmd(input.data() + start_pos, position - start_pos);
 
 	const CommandInfo *info = LatexParser::find_command(cmd);
+	CommandId id = info ? info->id : CommandId::NONE;
 	TokenType type = info ? info->type_override : TokenType::COMMAND;
 
-	tokens.push_back({cmd, info, type, start_line, start_column});
+	tokens.push(start_pos, cmd.size(), type, id);
 }
 
 /// @brief DISPATCH: <
 /// @param tokens: The current tokens
-void Lexer::handle_less(std::vector<Token> &tokens)
+void Lexer::handle_less(TokenStream &tokens)
 {
-	int s_line = line;
-	int s_col = column;
 	size_t s_pos = position;
 	advance();
 
 	if (peek() == '=')
 	{
 		advance();
-		tokens.push_back({std::string_view(input.data() + s_pos, 2),
-				nullptr, TokenType::LESS_EQUAL, s_line, s_col});
+		tokens.push(s_pos, 2, TokenType::LESS_EQUAL, CommandId::NONE);
 	}
 	else
 	{
-		tokens.push_back({std::string_view(input.data() + s_pos, 1),
-				nullptr, TokenType::LESS, s_line, s_col});
+		tokens.push(s_pos, 1, TokenType::LESS, CommandId::NONE);
 	}
 }
 
 /// @brief DISPATCH: >
 /// @param tokens: The current tokens
-void Lexer::handle_greater(std::vector<Token> &tokens)
+void Lexer::handle_greater(TokenStream &tokens)
 {
-	int s_line = line;
-	int s_col = column;
 	size_t s_pos = position;
 	advance();
 
 	if (peek() == '=')
 	{
 		advance();
-		tokens.push_back({std::string_view(input.data() + s_pos, 2),
-				nullptr, TokenType::GREATER_EQUAL, s_line, s_col});
+		tokens.push(s_pos, 2, TokenType::GREATER_EQUAL, CommandId::NONE);
 	}
 	else
 	{
-		tokens.push_back({std::string_view(input.data() + s_pos, 1),
-				nullptr, TokenType::GREATER, s_line, s_col});
+		tokens.push(s_pos, 1, TokenType::GREATER, CommandId::NONE);
 	}
 }
 
 /// @brief DISPATCH: COMMENT
 /// @param tokens: The current tokens
-void Lexer::handle_comment(std::vector<Token> &tokens)
+void Lexer::handle_comment(TokenStream &tokens)
 {
-	while (peek() != '\n' && peek() != '\0')
-	{
-		advance();
-	}
+	advance_run(scanner->comment(input.data() + position, input.data() + input.size()));
 
 	if (peek() == '\n')
 	{
@@ -268,72 +246,91 @@ void Lexer::handle_comment(std::vector<Token> &tokens)
 
 /// @brief DISPATCH: WHITESPACE
 /// @param tokens: The current tokens
-void Lexer::handle_whitespace(std::vector<Token> &tokens)
+void Lexer::handle_whitespace(TokenStream &tokens)
 {
-	while (peek() == ' ' || peek() == '\t' || peek() == '\n')
-	{
-		advance();
-	}
+	advance_run(scanner->whitespace(input.data() + position, input.data() + input.size()));
 }
 
 /// @brief DISPATCH: INVALID
 /// @param tokens: The current tokens
-void Lexer::handle_invalid(std::vector<Token> &tokens)
+void Lexer::handle_invalid(TokenStream &tokens)
 {
-	int start_line = line;
-	int start_column = column;
 	size_t start = position;
 
 	advance();
 
-	tokens.push_back({std::string_view(input.data() + start, 1),
-			nullptr,
-			TokenType::INVALID,
-			start_line,
-			start_column});
+	tokens.push(start, 1, TokenType::INVALID, CommandId::NONE);
 }
 
 /// @brief DISPATCH: IDENTIFIER
 /// @param tokens: The current tokens
-void Lexer::handle_identifier(std::vector<Token> &tokens)
+void Lexer::handle_identifier(TokenStream &tokens)
 {
-	int start_line = line;
-	int start_column = column;
 	size_t start = position;
 
 	advance();
+	advance_run(scanner->alpha(input.data() + position, input.data() + input.size()));
 
-	while (std::isalpha(static_cast<unsigned char>(peek())))
-	{
-		advance();
-	}
-
-	tokens.push_back({std::string_view(input.data() + start, position - start),
-			nullptr,
-			TokenType::IDENTIFIER,
-			start_line,
-			start_column});
+	tokens.push(start, position - start, TokenType::IDENTIFIER, CommandId::NONE);
 }
 
 /// @brief Tokenize the current input
-/// @return std::vector<Token>
-std::vector<Token> Lexer::tokenize()
+/// @return TokenStream, its source is the lexer's text
+/// @throws std::length_error if the text is 4 GiB or larger
+TokenStream Lexer::tokenize()
+{
+	TokenStream tokens;
+	tokenize(tokens);
+
+	return tokens;
+}
+
+/// @brief Tokenize the current input into an existing stream, reusing its capacity
+/// @param tokens: Stream to overwrite, its source becomes the lexer's text
+/// @throws std::length_error if the text is 4 GiB or larger
+void Lexer::tokenize(TokenStream &tokens)
 {
-	std::vector<Token> tokens;
+	if (input.size() > UINT32_MAX)
+		throw std::length_error("Lexer input exceeds the 32 bit token offset range");
+
+	tokens.clear(input);
 	tokens.reserve(input.size() / 4);
 
 	while (position < input.size())
 	{
-		unsigned char current = static_cast<unsigned char>(peek());
-		LexerAction action = LEXER_DISPATCH_TABLE[current];
-		action(this, tokens);
-	}
+		unsigned char current = static_cast<unsigned char>(input[position]);
 
-	tokens.push_back({std::string_view(input.data() + position, 0),
-			nullptr,
-			TokenType::END_OF_FILE,
-			line,
-			column});
+		switch (CHAR_LOOKUP.classes[current])
+		{
+			case CharClass::DIGIT:
+				handle_number(tokens);
+				break;
+			case CharClass::ALPHA:
+				handle_identifier(tokens);
+				break;
+			case CharClass::WHITESPACE:
+				handle_whitespace(tokens);
+				break;
+			case CharClass::COMMAND:
+				handle_command(tokens);
+				break;
+			case CharClass::LESS:
+				handle_less(tokens);
+				break;
+			case CharClass::GREATER:
+				handle_greater(tokens);
+				break;
+			case CharClass::COMMENT:
+				handle_comment(tokens);
+				break;
+			case CharClass::SINGLE_CHAR:
+				handle_single_char(tokens, CHAR_LOOKUP.types[current]);
+				break;
+			case CharClass::INVALID:
+				handle_invalid(tokens);
+				break;
+		}
+	}
 
-	return tokens;
+	tokens.push(position, 0, TokenType::END_OF_FILE, CommandId::NONE);
 }
@@ -1,15 +1,16 @@
 #ifndef TOKEN_INFO_HPP
 #define TOKEN_INFO_HPP
 
+#include <cstdint>
 #include <string_view>
 
 // ======================
 // -- ENUMS / STRUCTS
 // ======================
 
-struct CommandInfo;
+enum class CommandId : uint16_t;
 
-enum class TokenType
+enum class TokenType : uint8_t
 {
 	NUMBER,
 	SYMBOL,
@@ -60,11 +61,10 @@ enum class TokenType
 
 struct Token
 {
-	std::string_view Value;            // std::string_view: Value of the string
-	const CommandInfo *Info = nullptr; // CommandInfo: Metadata for each token
-	TokenType Type;                    // TokenType: Type of token
-	int line;                          // int: Current line
-	int column;                        // int: Current column
+	std::string_view Value; // std::string_view: Value of the string
+	CommandId Id;           // CommandId: Registered command or CommandId::NONE
+	TokenType Type;         // TokenType: Type of token
+	uint32_t offset;        // uint32_t: Byte offset into the source, see SourceMap for line / column
 };
 
 #endif
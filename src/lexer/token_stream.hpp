@@ -0,0 +1,182 @@
+#ifndef TOKEN_STREAM_HPP
+#define TOKEN_STREAM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "./token_info.hpp"
+
+// ======================
+// -- TokenStream
+// ======================
+
+/// @brief Tokens stored as parallel arrays, a Token is only built when asked for
+/// @note Offsets are 32 bit, inputs must be smaller than 4 GiB
+class TokenStream
+{
+	public:
+		static constexpr uint16_t LONG_LENGTH = 0xFFFF;
+
+		std::string_view source;                                // std::string_view: Text the offsets point into
+		std::vector<uint32_t> offsets;                          // std::vector: Byte offset of each token
+		std::vector<uint16_t> lengths;                          // std::vector: Byte length, LONG_LENGTH if in long_lengths
+		std::vector<TokenType> types;                           // std::vector: Type of each token
+		std::vector<CommandId> ids;                             // std::vector: Command side table, CommandId::NONE if not a command
+		std::vector<std::pair<uint32_t, uint32_t>> long_lengths; // std::vector: (index, length) of tokens >= LONG_LENGTH bytes
+
+		// ======================
+		// -- PUBLIC METHODS
+		// ======================
+
+		/// @brief Reserve space for a # of tokens
+		/// @param count: # of tokens
+		void reserve(size_t count)
+		{
+			offsets.reserve(count);
+			lengths.reserve(count);
+			types.reserve(count);
+			ids.reserve(count);
+		}
+
+		/// @brief Drop every token, keeping the capacity for the next input
+		/// @param text: Text the next tokens point into
+		void clear(std::string_view text)
+		{
+			source = text;
+			offsets.clear();
+			lengths.clear();
+			types.clear();
+			ids.clear();
+			long_lengths.clear();
+		}
+
+		/// @brief Append a token
+		/// @param offset: Byte offset into source
+		/// @param length: Byte length
+		/// @param type: Type of the token
+		/// @param id: Registered command or CommandId::NONE
+		void push(size_t offset, size_t length, TokenType type, CommandId id)
+		{
+			if (length >= LONG_LENGTH)
+				long_lengths.emplace_back(static_cast<uint32_t>(offsets.size()), static_cast<uint32_t>(length));
+
+			offsets.push_back(static_cast<uint32_t>(offset));
+			lengths.push_back(length >= LONG_LENGTH ? LONG_LENGTH : static_cast<uint16_t>(length));
+			types.push_back(type);
+			ids.push_back(id);
+		}
+
+		/// @brief # of tokens, including END_OF_FILE
+		/// @return size_t
+		size_t size() const { return types.size(); }
+
+		/// @brief Byte length of a token
+		/// @param index: Index of the token
+		/// @return size_t
+		size_t length(size_t index) const
+		{
+			if (lengths[index] != LONG_LENGTH) [[likely]]
+				return lengths[index];
+
+			auto it = std::lower_bound(long_lengths.begin(), long_lengths.end(), std::pair<uint32_t, uint32_t>(static_cast<uint32_t>(index), 0));
+			return it->second;
+		}
+
+		/// @brief Text of a token
+		/// @param index: Index of the token
+		/// @return std::string_view into source
+		std::string_view value(size_t index) const
+		{
+			return std::string_view(source.data() + offsets[index], length(index));
+		}
+
+		/// @brief Build the Token at an index
+		/// @param index: Index of the token
+		/// @return Token
+		Token operator[](size_t index) const
+		{
+			return {value(index), ids[index], types[index], offsets[index]};
+		}
+
+		/// @brief Heap bytes held by the token arrays
+		/// @return size_t
+		size_t memory_usage() const
+		{
+			return offsets.capacity() * sizeof(uint32_t) + lengths.capacity() * sizeof(uint16_t) +
+				types.capacity() * sizeof(TokenType) + ids.capacity() * sizeof(CommandId) +
+				long_lengths.capacity() * sizeof(std::pair<uint32_t, uint32_t>);
+		}
+};
+
+// ======================
+// -- TokenCursor
+// ======================
+
+/// @brief Forward cursor over a TokenStream
+/// @note The stream must end with END_OF_FILE, the cursor never moves past it
+class TokenCursor
+{
+	private:
+		const TokenStream *_stream = nullptr;
+		size_t _position = 0;
+
+	public:
+		/// @brief Default Constructor
+		TokenCursor() = default;
+
+		/// @brief Cursor at the first token of a stream
+		/// @param stream: The stream to read, borrowed
+		explicit TokenCursor(const TokenStream &stream) : _stream(&stream) {}
+
+		/// @brief The stream being read
+		/// @return const TokenStream&
+		const TokenStream &stream() const { return *_stream; }
+
+		/// @brief Index of the current token
+		/// @return size_t
+		size_t position() const { return _position; }
+
+		/// @brief Type of the current token
+		/// @return TokenType
+		TokenType type() const { return _stream->types[_position]; }
+
+		/// @brief Type of the token after the current one, END_OF_FILE past the end
+		/// @return TokenType
+		TokenType peek_type() const
+		{
+			size_t next = _position + 1 < _stream->size() ? _position + 1 : _stream->size() - 1;
+			return _stream->types[next];
+		}
+
+		/// @brief Build the current token
+		/// @return Token
+		Token token() const { return (*_stream)[_position]; }
+
+		/// @brief Build the token after the current one, END_OF_FILE past the end
+		/// @return Token
+		Token peek() const
+		{
+			size_t next = _position + 1 < _stream->size() ? _position + 1 : _stream->size() - 1;
+			return (*_stream)[next];
+		}
+
+		/// @brief Move to a token index, clamped to END_OF_FILE
+		/// @param position: Index of the token
+		void seek(size_t position)
+		{
+			_position = position < _stream->size() ? position : _stream->size() - 1;
+		}
+
+		/// @brief Move to the next token, stays on END_OF_FILE
+		void advance()
+		{
+			if (_position + 1 < _stream->size())
+				_position++;
+		}
+};
+
+#endif
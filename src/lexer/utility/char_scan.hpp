@@ -0,0 +1,52 @@
+#ifndef CHAR_SCAN_HPP
+#define CHAR_SCAN_HPP
+
+#include <cstddef>
+
+// ======================
+// -- ENUMS / STRUCTS
+// ======================
+
+namespace CharScan
+{
+	enum class Kernel
+	{
+		SCALAR,
+		SSE2,
+		AVX2,
+		AVX512,
+		AUTO
+	};
+
+	using RunScanner = size_t (*)(const char *begin, const char *end);
+
+	struct ScanKernel
+	{
+		Kernel kind;           // Kernel: Instruction set the scanners are built for
+		RunScanner whitespace; // RunScanner: Length of a ' ', '\t', '\n' run
+		RunScanner alpha;      // RunScanner: Length of a 'a'-'z', 'A'-'Z' run
+		RunScanner digit;      // RunScanner: Length of a '0'-'9' run
+		RunScanner comment;    // RunScanner: Length of a run up to '\n' or '\0'
+		RunScanner line;       // RunScanner: Length of a run up to '\n'
+	};
+
+	// ======================
+	// -- PUBLIC METHODS
+	// ======================
+
+	/// @brief Detect the widest kernel supported by the current CPU
+	/// @return Kernel
+	Kernel detect_kernel();
+
+	/// @brief Check if a kernel can run on the current CPU
+	/// @param kernel: The kernel to check
+	/// @return True if supported
+	bool is_supported(Kernel kernel);
+
+	/// @brief Get the run scanners for a kernel
+	/// @param kernel: The kernel to use, AUTO (or an unsupported kernel) picks the best one for the CPU
+	/// @return const ScanKernel&
+	const ScanKernel &get_kernel(Kernel kernel = Kernel::AUTO);
+}
+
+#endif
@@ -0,0 +1,360 @@
+#include <cstdint>
+
+#include "./char_scan.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CHAR_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// ======================
+// -- INIT
+// ======================
+
+namespace
+{
+	enum class ScanClass
+	{
+		WHITESPACE,
+		ALPHA,
+		DIGIT,
+		COMMENT,
+		LINE
+	};
+
+	// ======================
+	// -- SCALAR
+	// ======================
+
+	/// @brief Check if a byte belongs to a scan class
+	/// @param c: The byte to check
+	/// @return True if it belongs to the class
+	template <ScanClass C>
+		constexpr bool in_class(unsigned char c)
+		{
+			if constexpr (C == ScanClass::WHITESPACE)
+				return c == ' ' || c == '\t' || c == '\n';
+			else if constexpr (C == ScanClass::ALPHA)
+				return static_cast<unsigned char>((c | 0x20) - 'a') <= 'z' - 'a';
+			else if constexpr (C == ScanClass::DIGIT)
+				return static_cast<unsigned char>(c - '0') <= 9;
+			else if constexpr (C == ScanClass::COMMENT)
+				return c != '\n' && c != '\0';
+			else
+				return c != '\n';
+		}
+
+	/// @brief Scan a run one byte at a time
+	/// @param begin: Start of the run
+	/// @param end: End of the input
+	/// @return Length of the run
+	template <ScanClass C>
+		size_t scalar_run(const char *begin, const char *end)
+		{
+			const char *p = begin;
+
+			while (p < end && in_class<C>(static_cast<unsigned char>(*p)))
+				p++;
+
+			return p - begin;
+		}
+
+#ifdef CHAR_SCAN_X86
+	// ======================
+	// -- SSE2 (16 BYTES / COMPARE)
+	// ======================
+
+	/// @brief Classify 16 bytes
+	/// @param v: The bytes to classify
+	/// @return 0xFF for each byte inside the class
+	template <ScanClass C>
+		__attribute__((target("sse2"))) __m128i sse2_classify(__m128i v)
+		{
+			if constexpr (C == ScanClass::WHITESPACE)
+			{
+				return _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+							_mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+						_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+			}
+			else if constexpr (C == ScanClass::ALPHA)
+			{
+				__m128i t = _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+				return _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8('z' - 'a')), t);
+			}
+			else if constexpr (C == ScanClass::DIGIT)
+			{
+				__m128i t = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+				return _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(9)), t);
+			}
+			else if constexpr (C == ScanClass::LINE)
+			{
+				return _mm_xor_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_set1_epi8(-1));
+			}
+			else
+			{
+				__m128i stop = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+						_mm_cmpeq_epi8(v, _mm_setzero_si128()));
+				return _mm_xor_si128(stop, _mm_set1_epi8(-1));
+			}
+		}
+
+	/// @brief Scan a run 16 bytes per step
+	/// @param begin: Start of the run
+	/// @param end: End of the input
+	/// @return Length of the run
+	template <ScanClass C>
+		__attribute__((target("sse2"))) size_t sse2_run(const char *begin, const char *end)
+		{
+			const char *p = begin;
+
+			while (end - p >= 16)
+			{
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+				uint32_t miss = ~static_cast<uint32_t>(_mm_movemask_epi8(sse2_classify<C>(v))) & 0xFFFF;
+
+				if (miss)
+					return (p - begin) + __builtin_ctz(miss);
+
+				p += 16;
+			}
+
+			return (p - begin) + scalar_run<C>(p, end);
+		}
+
+	// ======================
+	// -- AVX2 (32 BYTES / COMPARE)
+	// ======================
+
+	/// @brief Classify 32 bytes
+	/// @param v: The bytes to classify
+	/// @return 0xFF for each byte inside the class
+	template <ScanClass C>
+		__attribute__((target("avx2"))) __m256i avx2_classify(__m256i v)
+		{
+			if constexpr (C == ScanClass::WHITESPACE)
+			{
+				return _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+							_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+						_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+			}
+			else if constexpr (C == ScanClass::ALPHA)
+			{
+				__m256i t = _mm256_sub_epi8(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+				return _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8('z' - 'a')), t);
+			}
+			else if constexpr (C == ScanClass::DIGIT)
+			{
+				__m256i t = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+				return _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8(9)), t);
+			}
+			else if constexpr (C == ScanClass::LINE)
+			{
+				return _mm256_xor_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), _mm256_set1_epi8(-1));
+			}
+			else
+			{
+				__m256i stop = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+						_mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+				return _mm256_xor_si256(stop, _mm256_set1_epi8(-1));
+			}
+		}
+
+	/// @brief Scan a run 32 bytes per step
+	/// @param begin: Start of the run
+	/// @param end: End of the input
+	/// @return Length of the run
+	template <ScanClass C>
+		__attribute__((target("avx2"))) size_t avx2_run(const char *begin, const char *end)
+		{
+			const char *p = begin;
+
+			while (end - p >= 32)
+			{
+				__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+				uint32_t miss = ~static_cast<uint32_t>(_mm256_movemask_epi8(avx2_classify<C>(v)));
+
+				if (miss)
+					return (p - begin) + __builtin_ctz(miss);
+
+				p += 32;
+			}
+
+			return (p - begin) + sse2_run<C>(p, end);
+		}
+
+	// ======================
+	// -- AVX-512 (64 BYTES / COMPARE)
+	// ======================
+
+	/// @brief Classify 64 bytes
+	/// @param v: The bytes to classify
+	/// @return One bit set for each byte inside the class
+	template <ScanClass C>
+		__attribute__((target("avx512f,avx512bw"))) uint64_t avx512_classify(__m512i v)
+		{
+			if constexpr (C == ScanClass::WHITESPACE)
+			{
+				return _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(' ')) |
+					_mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\t')) |
+					_mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\n'));
+			}
+			else if constexpr (C == ScanClass::ALPHA)
+			{
+				__m512i t = _mm512_sub_epi8(_mm512_or_si512(v, _mm512_set1_epi8(0x20)), _mm512_set1_epi8('a'));
+				return _mm512_cmple_epu8_mask(t, _mm512_set1_epi8('z' - 'a'));
+			}
+			else if constexpr (C == ScanClass::DIGIT)
+			{
+				__m512i t = _mm512_sub_epi8(v, _mm512_set1_epi8('0'));
+				return _mm512_cmple_epu8_mask(t, _mm512_set1_epi8(9));
+			}
+			else if constexpr (C == ScanClass::LINE)
+			{
+				return ~_mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\n'));
+			}
+			else
+			{
+				return ~(_mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\n')) |
+						_mm512_cmpeq_epi8_mask(v, _mm512_setzero_si512()));
+			}
+		}
+
+	/// @brief Scan a run 64 bytes per step
+	/// @param begin: Start of the run
+	/// @param end: End of the input
+	/// @return Length of the run
+	template <ScanClass C>
+		__attribute__((target("avx512f,avx512bw"))) size_t avx512_run(const char *begin, const char *end)
+		{
+			const char *p = begin;
+
+			while (end - p >= 64)
+			{
+				uint64_t mask = avx512_classify<C>(_mm512_loadu_si512(p));
+
+				if (~mask)
+					return (p - begin) + __builtin_ctzll(~mask);
+
+				p += 64;
+			}
+
+			return (p - begin) + avx2_run<C>(p, end);
+		}
+#endif
+
+	// ======================
+	// -- KERNEL TABLES
+	// ======================
+
+	constexpr CharScan::ScanKernel SCALAR_KERNEL{
+		CharScan::Kernel::SCALAR,
+		&scalar_run<ScanClass::WHITESPACE>,
+		&scalar_run<ScanClass::ALPHA>,
+		&scalar_run<ScanClass::DIGIT>,
+		&scalar_run<ScanClass::COMMENT>,
+		&scalar_run<ScanClass::LINE>};
+
+#ifdef CHAR_SCAN_X86
+	constexpr CharScan::ScanKernel SSE2_KERNEL{
+		CharScan::Kernel::SSE2,
+		&sse2_run<ScanClass::WHITESPACE>,
+		&sse2_run<ScanClass::ALPHA>,
+		&sse2_run<ScanClass::DIGIT>,
+		&sse2_run<ScanClass::COMMENT>,
+		&sse2_run<ScanClass::LINE>};
+
+	constexpr CharScan::ScanKernel AVX2_KERNEL{
+		CharScan::Kernel::AVX2,
+		&avx2_run<ScanClass::WHITESPACE>,
+		&avx2_run<ScanClass::ALPHA>,
+		&avx2_run<ScanClass::DIGIT>,
+		&avx2_run<ScanClass::COMMENT>,
+		&avx2_run<ScanClass::LINE>};
+
+	constexpr CharScan::ScanKernel AVX512_KERNEL{
+		CharScan::Kernel::AVX512,
+		&avx512_run<ScanClass::WHITESPACE>,
+		&avx512_run<ScanClass::ALPHA>,
+		&avx512_run<ScanClass::DIGIT>,
+		&avx512_run<ScanClass::COMMENT>,
+		&avx512_run<ScanClass::LINE>};
+#endif
+}
+
+// ======================
+// -- METHODS
+// ======================
+
+namespace CharScan
+{
+	/// @brief Detect the widest kernel supported by the current CPU
+	/// @return Kernel
+	Kernel detect_kernel()
+	{
+		static const Kernel detected = []
+		{
+			if (is_supported(Kernel::AVX512))
+				return Kernel::AVX512;
+
+			if (is_supported(Kernel::AVX2))
+				return Kernel::AVX2;
+
+			if (is_supported(Kernel::SSE2))
+				return Kernel::SSE2;
+
+			return Kernel::SCALAR;
+		}();
+
+		return detected;
+	}
+
+	/// @brief Check if a kernel can run on the current CPU
+	/// @param kernel: The kernel to check
+	/// @return True if supported
+	bool is_supported(Kernel kernel)
+	{
+#ifdef CHAR_SCAN_X86
+		__builtin_cpu_init();
+
+		switch (kernel)
+		{
+			case Kernel::SCALAR:
+			case Kernel::AUTO:
+				return true;
+			case Kernel::SSE2:
+				return __builtin_cpu_supports("sse2");
+			case Kernel::AVX2:
+				return __builtin_cpu_supports("avx2");
+			case Kernel::AVX512:
+				return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+		}
+
+		return false;
+#else
+		return kernel == Kernel::SCALAR || kernel == Kernel::AUTO;
+#endif
+	}
+
+	/// @brief Get the run scanners for a kernel
+	/// @param kernel: The kernel to use, AUTO (or an unsupported kernel) picks the best one for the CPU
+	/// @return const ScanKernel&
+	const ScanKernel &get_kernel(Kernel kernel)
+	{
+		if (kernel == Kernel::AUTO || !is_supported(kernel))
+			kernel = detect_kernel();
+
+		switch (kernel)
+		{
+#ifdef CHAR_SCAN_X86
+			case Kernel::SSE2:
+				return SSE2_KERNEL;
+			case Kernel::AVX2:
+				return AVX2_KERNEL;
+			case Kernel::AVX512:
+				return AVX512_KERNEL;
+#endif
+			default:
+				return SCALAR_KERNEL;
+		}
+	}
+}
@@ -0,0 +1,76 @@
+#ifndef SOURCE_MAP_HPP
+#define SOURCE_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "./char_scan.hpp"
+
+// ======================
+// -- ENUMS / STRUCTS
+// ======================
+
+struct SourceLocation
+{
+	int line;   // int: 1-based line
+	int column; // int: 1-based byte column
+};
+
+// ======================
+// -- SourceMap
+// ======================
+
+/// @brief Byte offset to line / column lookup
+/// @note Newline offsets are collected on the first lookup, valid inputs never pay for them
+class SourceMap
+{
+	private:
+		// ======================
+		// -- PRIVATE DATA
+		// ======================
+
+		std::string_view source;
+		const CharScan::ScanKernel *scanner = &CharScan::get_kernel();
+
+		mutable std::vector<uint32_t> newlines;
+		mutable bool built = false;
+
+		/// @brief Collect the offset of every '\n'
+		void build() const;
+
+	public:
+		// ======================
+		// -- CONSTRUCTOR
+		// ======================
+
+		/// @brief Default Constructor
+		SourceMap() = default;
+
+		/// @brief SourceMap Constructor
+		/// @param text: The text offsets refer to, borrowed (not copied)
+		/// @param kernel: The character-class scanning kernel, AUTO picks by CPU feature
+		explicit SourceMap(std::string_view text, CharScan::Kernel kernel = CharScan::Kernel::AUTO)
+			: source(text), scanner(&CharScan::get_kernel(kernel)) {}
+
+		// ======================
+		// -- PUBLIC METHODS
+		// ======================
+
+		/// @brief Point the map at new text, keeping the newline buffer
+		/// @param text: The text offsets refer to, borrowed (not copied)
+		void reset(std::string_view text)
+		{
+			source = text;
+			newlines.clear();
+			built = false;
+		}
+
+		/// @brief Line and column of a byte offset
+		/// @param offset: Byte offset into the text
+		/// @return SourceLocation
+		SourceLocation locate(size_t offset) const;
+};
+
+#endif
@@ -0,0 +1,44 @@
+#include <algorithm>
+
+#include "./source_map.hpp"
+
+// ======================
+// -- METHODS
+// ======================
+
+/// @brief Collect the offset of every '\n'
+void SourceMap::build() const
+{
+	const char *begin = source.data();
+	const char *end = begin + source.size();
+	const char *p = begin;
+
+	while (p < end)
+	{
+		p += scanner->line(p, end);
+
+		if (p < end)
+		{
+			newlines.push_back(static_cast<uint32_t>(p - begin));
+			p++;
+		}
+	}
+
+	built = true;
+}
+
+/// @brief Line and column of a byte offset
+/// @param offset: Byte offset into the text
+/// @return SourceLocation
+SourceLocation SourceMap::locate(size_t offset) const
+{
+	if (!built)
+		build();
+
+	// # of newlines before offset is the 0-based line
+	auto it = std::lower_bound(newlines.begin(), newlines.end(), static_cast<uint32_t>(offset));
+	size_t line = it - newlines.begin();
+	size_t line_start = line == 0 ? 0 : newlines[line - 1] + 1;
+
+	return {static_cast<int>(line + 1), static_cast<int>(offset - line_start + 1)};
+}
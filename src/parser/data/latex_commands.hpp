@@ -1,8 +1,11 @@
 #ifndef LATEX_COMMANDS_HPP
 #define LATEX_COMMANDS_HPP
 
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
 #include <string_view>
-#include <unordered_map>
 
 #include "./latex_info.hpp"
 
@@ -12,12 +15,184 @@
 
 namespace LatexParser
 {
-	extern const std::unordered_map<std::string_view, CommandInfo> LATEX_COMMANDS;
+	// ======================
+	// -- ENUMS / STRUCTS
+	// ======================
+
+	struct CommandEntry
+	{
+		std::string_view name; // std::string_view: Name of the command including the '\'
+		CommandInfo info;      // CommandInfo: Metadata for the command
+	};
+
+	/// @brief Perfect hash over all registered commands (hash and displace)
+	/// @note Built at compile time, lookups hash the name once and probe exactly one slot
+	struct CommandTable
+	{
+		static constexpr size_t BUCKET_BITS = 7;
+		static constexpr size_t SLOT_BITS = 9;
+		static constexpr size_t BUCKET_COUNT = size_t{1} << BUCKET_BITS;
+		static constexpr size_t SLOT_COUNT = size_t{1} << SLOT_BITS;
+		static constexpr uint16_t EMPTY_SLOT = 0xFFFF;
+
+		const CommandEntry *entries = nullptr;       // const CommandEntry*: All registered commands
+		size_t count = 0;                            // size_t: # of registered commands
+		std::array<uint16_t, BUCKET_COUNT> seeds{};  // std::array: Displacement seed per bucket
+		std::array<uint16_t, SLOT_COUNT> slots{};    // std::array: Entry index per slot or EMPTY_SLOT
+	};
+
+	// ======================
+	// -- HASHING
+	// ======================
+
+	/// @brief FNV-1a hash of a command name
+	/// @param name: The name of the command
+	/// @return uint64_t
+	constexpr uint64_t hash_command(std::string_view name)
+	{
+		uint64_t hash = 0xCBF29CE484222325ull;
+
+		for (char c : name)
+		{
+			hash ^= static_cast<unsigned char>(c);
+			hash *= 0x100000001B3ull;
+		}
+
+		return hash;
+	}
+
+	/// @brief Bucket of a hashed command name
+	/// @param hash: Hash from hash_command
+	/// @return size_t
+	constexpr size_t command_bucket(uint64_t hash)
+	{
+		return (hash >> 32) & (CommandTable::BUCKET_COUNT - 1);
+	}
+
+	/// @brief Slot of a hashed command name for a displacement seed
+	/// @param hash: Hash from hash_command
+	/// @param seed: Displacement seed of the bucket
+	/// @return size_t
+	constexpr size_t command_slot(uint64_t hash, uint16_t seed)
+	{
+		return ((hash ^ (seed * 0x9E3779B97F4A7C15ull)) * 0xBF58476D1CE4E5B9ull) >> (64 - CommandTable::SLOT_BITS);
+	}
+
+	/// @brief Build the perfect hash table for a set of commands
+	/// @tparam N: # of commands
+	/// @param entries: All registered commands, names must be unique
+	/// @return CommandTable
+	template <size_t N>
+		constexpr CommandTable build_command_table(const CommandEntry (&entries)[N])
+		{
+			static_assert(N < CommandTable::SLOT_COUNT * 3 / 4, "CommandTable::SLOT_BITS is too small for the registry");
+
+			CommandTable table{};
+			table.entries = entries;
+			table.count = N;
+
+			for (auto &slot : table.slots)
+				slot = CommandTable::EMPTY_SLOT;
+
+			std::array<uint64_t, N> hashes{};
+			std::array<size_t, CommandTable::BUCKET_COUNT> bucket_sizes{};
+			size_t largest_bucket = 0;
+
+			for (size_t i = 0; i < N; i++)
+			{
+				hashes[i] = hash_command(entries[i].name);
+
+				size_t size = ++bucket_sizes[command_bucket(hashes[i])];
+				largest_bucket = size > largest_bucket ? size : largest_bucket;
+			}
+
+			// Place the largest buckets first while the table is still sparse
+			for (size_t size = largest_bucket; size > 0; size--)
+			{
+				for (size_t bucket = 0; bucket < CommandTable::BUCKET_COUNT; bucket++)
+				{
+					if (bucket_sizes[bucket] != size)
+						continue;
+
+					bool placed = false;
+
+					for (uint32_t seed = 0; seed <= 0xFFFF && !placed; seed++)
+					{
+						placed = true;
+
+						for (size_t i = 0; i < N && placed; i++)
+						{
+							if (command_bucket(hashes[i]) != bucket)
+								continue;
+
+							size_t slot = command_slot(hashes[i], static_cast<uint16_t>(seed));
+
+							if (table.slots[slot] != CommandTable::EMPTY_SLOT)
+								placed = false;
+							else
+								table.slots[slot] = static_cast<uint16_t>(i);
+						}
+
+						if (placed)
+						{
+							table.seeds[bucket] = static_cast<uint16_t>(seed);
+							continue;
+						}
+
+						for (size_t i = 0; i < N; i++)
+						{
+							if (command_bucket(hashes[i]) != bucket)
+								continue;
+
+							size_t slot = command_slot(hashes[i], static_cast<uint16_t>(seed));
+
+							if (table.slots[slot] == i)
+								table.slots[slot] = CommandTable::EMPTY_SLOT;
+						}
+					}
+
+					if (!placed)
+						throw std::logic_error("No displacement seed found for a command bucket");
+				}
+			}
+
+			return table;
+		}
+
+	/// @brief Check that every entry's CommandId is its index in the registry
+	/// @tparam N: # of commands
+	/// @param entries: All registered commands
+	/// @return True if the ids are dense and in registry order
+	template <size_t N>
+		constexpr bool has_dense_ids(const CommandEntry (&entries)[N])
+		{
+			if (N != static_cast<size_t>(CommandId::COUNT))
+				return false;
+
+			for (size_t i = 0; i < N; i++)
+			{
+				if (static_cast<size_t>(entries[i].info.id) != i)
+					return false;
+			}
+
+			return true;
+		}
+
+	// ======================
+	// -- REGISTRY
+	// ======================
+
+	extern const CommandTable LATEX_COMMANDS;
 
 	/// @brief Find the CommandType for a specific CommandType
 	/// @param name: The name of the command
 	/// @return const CommandInfo*
 	const CommandInfo *find_command(const std::string_view name);
+
+	/// @brief Get the CommandInfo for a CommandId
+	/// @param id: The id of the command
+	/// @return const CommandInfo* or nullptr for CommandId::NONE
+	const CommandInfo *get_command(CommandId id);
 }
 
 #endif
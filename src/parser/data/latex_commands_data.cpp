@@ -1,5 +1,3 @@
-#include <unordered_map>
-
 #include "./latex_commands.hpp"
 
 // ======================
@@ -8,250 +6,257 @@
 
 namespace LatexParser
 {
-	const std::unordered_map<std::string_view, CommandInfo> LATEX_COMMANDS = {
-
-		// ======================
-		// -- GREEK LETTERS
-		// ======================
-
-		{"\\alpha", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\beta", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\gamma", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\delta", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\epsilon", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\varepsilon", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\zeta", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\eta", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\theta", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\vartheta", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\iota", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\kappa", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\lambda", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\mu", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\nu", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\xi", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\pi", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\rho", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\sigma", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\varsigma", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\tau", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\upsilon", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\phi", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\varphi", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\chi", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\psi", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\omega", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-
-		{"\\Gamma", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Delta", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Theta", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Lambda", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Xi", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Pi", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Sigma", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Upsilon", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Phi", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Psi", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Omega", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-
-		// ======================
-		// -- TRIG
-		// ======================
-
-		{"\\sin", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\cos", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\tan", {CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\csc", {CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\sec", {CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\cot", {CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\sinh", {CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\cosh", {CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\tanh", {CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\arcsin", {CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\arccos", {CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\arctan", {CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
-
-		// ======================
-		// -- CALC / OPERATORS
-		// ======================
-
-		{"\\lim", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\sup", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\inf", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\max", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\min", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\log", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\ln", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\exp", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\det", {CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\dim", {CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\ker", {CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\gcd", {CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
-
-		{"\\partial", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-
-		// ======================
-		// -- INTERGRALS / SUMS / PRODUCTS
-		// ======================
-
-		{"\\int", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\iint", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\iiint", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\oint", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\sum", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\prod", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\bigcup", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\bigcap", {CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
-
-		// ======================
-		// -- FRACTIONS / ROOTS / MODIFIERS
-		// ======================
-
-		{"\\frac", {CommandType::MATH, TokenType::COMMAND, 2, 0, true, true}},
-		{"\\binom", {CommandType::MATH, TokenType::COMMAND, 2, 0, true, true}},
-		{"\\choose", {CommandType::MATH, TokenType::COMMAND, 2, 0, true, true}},
-		{"\\sqrt", {CommandType::MATH, TokenType::COMMAND, 1, 1, true, true}},
-		{"\\bar", {CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\hat", {CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\tilde", {CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\dot", {CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\ddot", {CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\vec", {CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\overline", {CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\underline", {CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\overbrace", {CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\underbrace", {CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
-
-		// ======================
-		// -- RELATIONS / LOGIC
-		// ======================
-
-		{"\\leq", {CommandType::SYMBOL, TokenType::LESS_EQUAL, 0, 0, true, true}},
-		{"\\geq", {CommandType::SYMBOL, TokenType::GREATER_EQUAL, 0, 0, true, true}},
-		{"\\neq", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\equiv", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\approx", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\sim", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\cong", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\propto", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\prec", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\succ", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\subset", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\subseteq", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\supset", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\supseteq", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\in", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\notin", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\forall", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\exists", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\neg", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\land", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\lor", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\implies", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\iff", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-
-		// ======================
-		// -- ARROWS
-		// ======================
-
-		{"\\leftarrow", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\rightarrow", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\leftrightarrow", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Leftarrow", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Rightarrow", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Leftrightarrow", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\uparrow", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\downarrow", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Uparrow", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\Downarrow", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\hookleftarrow", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\hookrightarrow", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\mapsto", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\longleftarrow", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\longrightarrow", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-
-		// ======================
-		// -- DELIMS / GEOMETRY
-		// ======================
-
-		{"\\langle", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\rangle", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\lfloor", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\rfloor", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\lceil", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\rceil", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\angle", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\measuredangle", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\triangle", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\square", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\perp", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\parallel", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-
-		// ======================
-		// -- DOTS / MISC SYMBOLS
-		// ======================
-
-		{"\\cdot", {CommandType::SYMBOL, TokenType::STAR, 0, 0, true, true}},
-		{"\\times", {CommandType::SYMBOL, TokenType::STAR, 0, 0, true, true}},
-		{"\\pm", {CommandType::SYMBOL, TokenType::PLUS_MINUS, 0, 0, true, true}},
-		{"\\mp", {CommandType::SYMBOL, TokenType::MINUS_PLUS, 0, 0, true, true}},
-		{"\\div", {CommandType::SYMBOL, TokenType::SLASH, 0, 0, true, true}},
-		{"\\star", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\bullet", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\dots", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\cdots", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\ldots", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\vdots", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\ddots", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\infty", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\emptyset", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\aleph", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\hbar", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\wp", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-		{"\\nabla", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-
-		// ======================
-		// -- FONTS / TEXT
-		// ======================
-
-		{"\\text", {CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\mathrm", {CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\mathbb", {CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\mathbf", {CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\mathcal", {CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\mathfrak", {CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\mathit", {CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\operatorname", {CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
-
-		// ======================
-		// -- ENV / STRUCTURES
-		// ======================
-
-		{"\\left", {CommandType::PREFIX_DELIMITER, TokenType::LEFT_WRAP, 0, 0, true, true}},
-		{"\\right", {CommandType::POSTFIX_DELIMITER, TokenType::RIGHT_WRAP, 0, 0, true, true}},
-
-		{"\\begin", {CommandType::PREFIX_DELIMITER, TokenType::ENV_BEGIN, 1, 0, true, true}},
-		{"\\end", {CommandType::POSTFIX_DELIMITER, TokenType::ENV_END, 1, 0, true, true}},
-
-		{"\\cases", {CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\matrix", {CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\pmatrix", {CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\bmatrix", {CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\vmatrix", {CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
-		{"\\Vmatrix", {CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
-
-		// ======================
-		// -- MISC
-		// ======================
-
-		{"\\to", {CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
-
-		{"\\[", {CommandType::SYMBOL, TokenType::DISPLAY_MATH_OPEN, 0, 0, true, true}},
-		{"\\]", {CommandType::SYMBOL, TokenType::DISPLAY_MATH_CLOSE, 0, 0, true, true}},
-		{"\\(", {CommandType::SYMBOL, TokenType::INLINE_MATH_OPEN, 0, 0, true, true}},
-		{"\\)", {CommandType::SYMBOL, TokenType::INLINE_MATH_CLOSE, 0, 0, true, true}},
-		{"\\{", {CommandType::SYMBOL, TokenType::ESCAPED_BRACE_OPEN, 0, 0, true, true}},
-		{"\\}", {CommandType::SYMBOL, TokenType::ESCAPED_BRACE_CLOSE, 0, 0, true, true}},
-		{R"(\\)", {CommandType::SYMBOL, TokenType::NEWLINE, 0, 0, true, true}},
-	};
+	namespace
+	{
+		constexpr CommandEntry COMMAND_ENTRIES[] = {
+
+			// ======================
+			// -- GREEK LETTERS
+			// ======================
+
+			{"\\alpha", {CommandId::ALPHA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\beta", {CommandId::BETA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\gamma", {CommandId::GAMMA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\delta", {CommandId::DELTA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\epsilon", {CommandId::EPSILON, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\varepsilon", {CommandId::VAREPSILON, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\zeta", {CommandId::ZETA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\eta", {CommandId::ETA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\theta", {CommandId::THETA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\vartheta", {CommandId::VARTHETA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\iota", {CommandId::IOTA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\kappa", {CommandId::KAPPA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\lambda", {CommandId::LAMBDA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\mu", {CommandId::MU, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\nu", {CommandId::NU, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\xi", {CommandId::XI, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\pi", {CommandId::PI, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\rho", {CommandId::RHO, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\sigma", {CommandId::SIGMA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\varsigma", {CommandId::VARSIGMA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\tau", {CommandId::TAU, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\upsilon", {CommandId::UPSILON, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\phi", {CommandId::PHI, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\varphi", {CommandId::VARPHI, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\chi", {CommandId::CHI, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\psi", {CommandId::PSI, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\omega", {CommandId::OMEGA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+
+			{"\\Gamma", {CommandId::CAPITAL_GAMMA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Delta", {CommandId::CAPITAL_DELTA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Theta", {CommandId::CAPITAL_THETA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Lambda", {CommandId::CAPITAL_LAMBDA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Xi", {CommandId::CAPITAL_XI, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Pi", {CommandId::CAPITAL_PI, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Sigma", {CommandId::CAPITAL_SIGMA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Upsilon", {CommandId::CAPITAL_UPSILON, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Phi", {CommandId::CAPITAL_PHI, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Psi", {CommandId::CAPITAL_PSI, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Omega", {CommandId::CAPITAL_OMEGA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+
+			// ======================
+			// -- TRIG
+			// ======================
+
+			{"\\sin", {CommandId::SIN, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\cos", {CommandId::COS, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\tan", {CommandId::TAN, CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\csc", {CommandId::CSC, CommandType::MATH, TokenType::COMMAND, 1, 0, true, true, CommandRule::RECIPROCAL_TRIG}},
+			{"\\sec", {CommandId::SEC, CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\cot", {CommandId::COT, CommandType::MATH, TokenType::COMMAND, 1, 0, true, true, CommandRule::RECIPROCAL_TRIG}},
+			{"\\sinh", {CommandId::SINH, CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\cosh", {CommandId::COSH, CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\tanh", {CommandId::TANH, CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\arcsin", {CommandId::ARCSIN, CommandType::MATH, TokenType::COMMAND, 1, 0, true, true, CommandRule::INVERSE_TRIG}},
+			{"\\arccos", {CommandId::ARCCOS, CommandType::MATH, TokenType::COMMAND, 1, 0, true, true, CommandRule::INVERSE_TRIG}},
+			{"\\arctan", {CommandId::ARCTAN, CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
+
+			// ======================
+			// -- CALC / OPERATORS
+			// ======================
+
+			{"\\lim", {CommandId::LIM, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\sup", {CommandId::SUP, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\inf", {CommandId::INF, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\max", {CommandId::MAX, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\min", {CommandId::MIN, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\log", {CommandId::LOG, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true, CommandRule::LOGARITHM}},
+			{"\\ln", {CommandId::LN, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true, CommandRule::LOGARITHM}},
+			{"\\exp", {CommandId::EXP, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\det", {CommandId::DET, CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\dim", {CommandId::DIM, CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\ker", {CommandId::KER, CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\gcd", {CommandId::GCD, CommandType::MATH, TokenType::COMMAND, 1, 0, true, true}},
+
+			{"\\partial", {CommandId::PARTIAL, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+
+			// ======================
+			// -- INTERGRALS / SUMS / PRODUCTS
+			// ======================
+
+			{"\\int", {CommandId::INT, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\iint", {CommandId::IINT, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\iiint", {CommandId::IIINT, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\oint", {CommandId::OINT, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\sum", {CommandId::SUM, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\prod", {CommandId::PROD, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\bigcup", {CommandId::BIGCUP, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\bigcap", {CommandId::BIGCAP, CommandType::MATH, TokenType::COMMAND, 0, 0, true, true}},
+
+			// ======================
+			// -- FRACTIONS / ROOTS / MODIFIERS
+			// ======================
+
+			{"\\frac", {CommandId::FRAC, CommandType::MATH, TokenType::COMMAND, 2, 0, true, true, CommandRule::DIVISOR}},
+			{"\\binom", {CommandId::BINOM, CommandType::MATH, TokenType::COMMAND, 2, 0, true, true, CommandRule::BINOMIAL}},
+			{"\\choose", {CommandId::CHOOSE, CommandType::MATH, TokenType::COMMAND, 2, 0, true, true, CommandRule::BINOMIAL}},
+			{"\\sqrt", {CommandId::SQRT, CommandType::MATH, TokenType::COMMAND, 1, 1, true, true, CommandRule::RADICAND}},
+			{"\\bar", {CommandId::BAR, CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\hat", {CommandId::HAT, CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\tilde", {CommandId::TILDE, CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\dot", {CommandId::DOT, CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\ddot", {CommandId::DDOT, CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\vec", {CommandId::VEC, CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\overline", {CommandId::OVERLINE, CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\underline", {CommandId::UNDERLINE, CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\overbrace", {CommandId::OVERBRACE, CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\underbrace", {CommandId::UNDERBRACE, CommandType::ACCENT, TokenType::COMMAND, 1, 0, true, true}},
+
+			// ======================
+			// -- RELATIONS / LOGIC
+			// ======================
+
+			{"\\leq", {CommandId::LEQ, CommandType::SYMBOL, TokenType::LESS_EQUAL, 0, 0, true, true}},
+			{"\\geq", {CommandId::GEQ, CommandType::SYMBOL, TokenType::GREATER_EQUAL, 0, 0, true, true}},
+			{"\\neq", {CommandId::NEQ, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\equiv", {CommandId::EQUIV, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\approx", {CommandId::APPROX, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\sim", {CommandId::SIM, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\cong", {CommandId::CONG, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\propto", {CommandId::PROPTO, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\prec", {CommandId::PREC, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\succ", {CommandId::SUCC, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\subset", {CommandId::SUBSET, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\subseteq", {CommandId::SUBSETEQ, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\supset", {CommandId::SUPSET, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\supseteq", {CommandId::SUPSETEQ, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\in", {CommandId::IN, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\notin", {CommandId::NOTIN, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\forall", {CommandId::FORALL, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\exists", {CommandId::EXISTS, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\neg", {CommandId::NEG, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\land", {CommandId::LAND, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\lor", {CommandId::LOR, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\implies", {CommandId::IMPLIES, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\iff", {CommandId::IFF, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+
+			// ======================
+			// -- ARROWS
+			// ======================
+
+			{"\\leftarrow", {CommandId::LEFTARROW, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\rightarrow", {CommandId::RIGHTARROW, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\leftrightarrow", {CommandId::LEFTRIGHTARROW, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Leftarrow", {CommandId::CAPITAL_LEFTARROW, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Rightarrow", {CommandId::CAPITAL_RIGHTARROW, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Leftrightarrow", {CommandId::CAPITAL_LEFTRIGHTARROW, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\uparrow", {CommandId::UPARROW, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\downarrow", {CommandId::DOWNARROW, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Uparrow", {CommandId::CAPITAL_UPARROW, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\Downarrow", {CommandId::CAPITAL_DOWNARROW, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\hookleftarrow", {CommandId::HOOKLEFTARROW, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\hookrightarrow", {CommandId::HOOKRIGHTARROW, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\mapsto", {CommandId::MAPSTO, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\longleftarrow", {CommandId::LONGLEFTARROW, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\longrightarrow", {CommandId::LONGRIGHTARROW, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+
+			// ======================
+			// -- DELIMS / GEOMETRY
+			// ======================
+
+			{"\\langle", {CommandId::LANGLE, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\rangle", {CommandId::RANGLE, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\lfloor", {CommandId::LFLOOR, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\rfloor", {CommandId::RFLOOR, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\lceil", {CommandId::LCEIL, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\rceil", {CommandId::RCEIL, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\angle", {CommandId::ANGLE, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\measuredangle", {CommandId::MEASUREDANGLE, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\triangle", {CommandId::TRIANGLE, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\square", {CommandId::SQUARE, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\perp", {CommandId::PERP, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\parallel", {CommandId::PARALLEL, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+
+			// ======================
+			// -- DOTS / MISC SYMBOLS
+			// ======================
+
+			{"\\cdot", {CommandId::CDOT, CommandType::SYMBOL, TokenType::STAR, 0, 0, true, true}},
+			{"\\times", {CommandId::TIMES, CommandType::SYMBOL, TokenType::STAR, 0, 0, true, true}},
+			{"\\pm", {CommandId::PM, CommandType::SYMBOL, TokenType::PLUS_MINUS, 0, 0, true, true}},
+			{"\\mp", {CommandId::MP, CommandType::SYMBOL, TokenType::MINUS_PLUS, 0, 0, true, true}},
+			{"\\div", {CommandId::DIV, CommandType::SYMBOL, TokenType::SLASH, 0, 0, true, true}},
+			{"\\star", {CommandId::STAR, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\bullet", {CommandId::BULLET, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\dots", {CommandId::DOTS, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\cdots", {CommandId::CDOTS, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\ldots", {CommandId::LDOTS, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\vdots", {CommandId::VDOTS, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\ddots", {CommandId::DDOTS, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\infty", {CommandId::INFTY, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\emptyset", {CommandId::EMPTYSET, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\aleph", {CommandId::ALEPH, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\hbar", {CommandId::HBAR, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\wp", {CommandId::WP, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+			{"\\nabla", {CommandId::NABLA, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+
+			// ======================
+			// -- FONTS / TEXT
+			// ======================
+
+			{"\\text", {CommandId::TEXT, CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\mathrm", {CommandId::MATHRM, CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\mathbb", {CommandId::MATHBB, CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\mathbf", {CommandId::MATHBF, CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\mathcal", {CommandId::MATHCAL, CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\mathfrak", {CommandId::MATHFRAK, CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\mathit", {CommandId::MATHIT, CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\operatorname", {CommandId::OPERATORNAME, CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
+
+			// ======================
+			// -- ENV / STRUCTURES
+			// ======================
+
+			{"\\left", {CommandId::LEFT, CommandType::PREFIX_DELIMITER, TokenType::LEFT_WRAP, 0, 0, true, true}},
+			{"\\right", {CommandId::RIGHT, CommandType::POSTFIX_DELIMITER, TokenType::RIGHT_WRAP, 0, 0, true, true}},
+
+			{"\\begin", {CommandId::BEGIN, CommandType::PREFIX_DELIMITER, TokenType::ENV_BEGIN, 1, 0, true, true}},
+			{"\\end", {CommandId::END, CommandType::POSTFIX_DELIMITER, TokenType::ENV_END, 1, 0, true, true}},
+
+			{"\\cases", {CommandId::CASES, CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\matrix", {CommandId::MATRIX, CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\pmatrix", {CommandId::PMATRIX, CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\bmatrix", {CommandId::BMATRIX, CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\vmatrix", {CommandId::VMATRIX, CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
+			{"\\Vmatrix", {CommandId::CAPITAL_VMATRIX, CommandType::TEXT, TokenType::COMMAND, 1, 0, true, true}},
+
+			// ======================
+			// -- MISC
+			// ======================
+
+			{"\\to", {CommandId::TO, CommandType::SYMBOL, TokenType::COMMAND, 0, 0, true, true}},
+
+			{"\\[", {CommandId::DISPLAY_MATH_OPEN, CommandType::SYMBOL, TokenType::DISPLAY_MATH_OPEN, 0, 0, true, true}},
+			{"\\]", {CommandId::DISPLAY_MATH_CLOSE, CommandType::SYMBOL, TokenType::DISPLAY_MATH_CLOSE, 0, 0, true, true}},
+			{"\\(", {CommandId::INLINE_MATH_OPEN, CommandType::SYMBOL, TokenType::INLINE_MATH_OPEN, 0, 0, true, true}},
+			{"\\)", {CommandId::INLINE_MATH_CLOSE, CommandType::SYMBOL, TokenType::INLINE_MATH_CLOSE, 0, 0, true, true}},
+			{"\\{", {CommandId::ESCAPED_BRACE_OPEN, CommandType::SYMBOL, TokenType::ESCAPED_BRACE_OPEN, 0, 0, true, true}},
+			{"\\}", {CommandId::ESCAPED_BRACE_CLOSE, CommandType::SYMBOL, TokenType::ESCAPED_BRACE_CLOSE, 0, 0, true, true}},
+			{R"(\\)", {CommandId::NEWLINE, CommandType::SYMBOL, TokenType::NEWLINE, 0, 0, true, true}},
+		};
+	}
+
+	static_assert(has_dense_ids(COMMAND_ENTRIES), "CommandId order must match COMMAND_ENTRIES");
+
+	constexpr CommandTable LATEX_COMMANDS = build_command_table(COMMAND_ENTRIES);
 }
@@ -1,6 +1,8 @@
 #ifndef LATEX_INFO_HPP
 #define LATEX_INFO_HPP
 
+#include <cstdint>
+
 #include "../lexer/token_info.hpp"
 
 // ======================
@@ -26,14 +28,240 @@ enum class ArgType
 	OPTIONAL
 };
 
+/// @note Order must match the registry in latex_commands_data.cpp (checked at compile time)
+enum class CommandId : uint16_t
+{
+	// GREEK LETTERS
+	ALPHA,
+	BETA,
+	GAMMA,
+	DELTA,
+	EPSILON,
+	VAREPSILON,
+	ZETA,
+	ETA,
+	THETA,
+	VARTHETA,
+	IOTA,
+	KAPPA,
+	LAMBDA,
+	MU,
+	NU,
+	XI,
+	PI,
+	RHO,
+	SIGMA,
+	VARSIGMA,
+	TAU,
+	UPSILON,
+	PHI,
+	VARPHI,
+	CHI,
+	PSI,
+	OMEGA,
+	CAPITAL_GAMMA,
+	CAPITAL_DELTA,
+	CAPITAL_THETA,
+	CAPITAL_LAMBDA,
+	CAPITAL_XI,
+	CAPITAL_PI,
+	CAPITAL_SIGMA,
+	CAPITAL_UPSILON,
+	CAPITAL_PHI,
+	CAPITAL_PSI,
+	CAPITAL_OMEGA,
+
+	// TRIG
+	SIN,
+	COS,
+	TAN,
+	CSC,
+	SEC,
+	COT,
+	SINH,
+	COSH,
+	TANH,
+	ARCSIN,
+	ARCCOS,
+	ARCTAN,
+
+	// CALC / OPERATORS
+	LIM,
+	SUP,
+	INF,
+	MAX,
+	MIN,
+	LOG,
+	LN,
+	EXP,
+	DET,
+	DIM,
+	KER,
+	GCD,
+	PARTIAL,
+
+	// INTERGRALS / SUMS / PRODUCTS
+	INT,
+	IINT,
+	IIINT,
+	OINT,
+	SUM,
+	PROD,
+	BIGCUP,
+	BIGCAP,
+
+	// FRACTIONS / ROOTS / MODIFIERS
+	FRAC,
+	BINOM,
+	CHOOSE,
+	SQRT,
+	BAR,
+	HAT,
+	TILDE,
+	DOT,
+	DDOT,
+	VEC,
+	OVERLINE,
+	UNDERLINE,
+	OVERBRACE,
+	UNDERBRACE,
+
+	// RELATIONS / LOGIC
+	LEQ,
+	GEQ,
+	NEQ,
+	EQUIV,
+	APPROX,
+	SIM,
+	CONG,
+	PROPTO,
+	PREC,
+	SUCC,
+	SUBSET,
+	SUBSETEQ,
+	SUPSET,
+	SUPSETEQ,
+	IN,
+	NOTIN,
+	FORALL,
+	EXISTS,
+	NEG,
+	LAND,
+	LOR,
+	IMPLIES,
+	IFF,
+
+	// ARROWS
+	LEFTARROW,
+	RIGHTARROW,
+	LEFTRIGHTARROW,
+	CAPITAL_LEFTARROW,
+	CAPITAL_RIGHTARROW,
+	CAPITAL_LEFTRIGHTARROW,
+	UPARROW,
+	DOWNARROW,
+	CAPITAL_UPARROW,
+	CAPITAL_DOWNARROW,
+	HOOKLEFTARROW,
+	HOOKRIGHTARROW,
+	MAPSTO,
+	LONGLEFTARROW,
+	LONGRIGHTARROW,
+
+	// DELIMS / GEOMETRY
+	LANGLE,
+	RANGLE,
+	LFLOOR,
+	RFLOOR,
+	LCEIL,
+	RCEIL,
+	ANGLE,
+	MEASUREDANGLE,
+	TRIANGLE,
+	SQUARE,
+	PERP,
+	PARALLEL,
+
+	// DOTS / MISC SYMBOLS
+	CDOT,
+	TIMES,
+	PM,
+	MP,
+	DIV,
+	STAR,
+	BULLET,
+	DOTS,
+	CDOTS,
+	LDOTS,
+	VDOTS,
+	DDOTS,
+	INFTY,
+	EMPTYSET,
+	ALEPH,
+	HBAR,
+	WP,
+	NABLA,
+
+	// FONTS / TEXT
+	TEXT,
+	MATHRM,
+	MATHBB,
+	MATHBF,
+	MATHCAL,
+	MATHFRAK,
+	MATHIT,
+	OPERATORNAME,
+
+	// ENV / STRUCTURES
+	LEFT,
+	RIGHT,
+	BEGIN,
+	END,
+	CASES,
+	MATRIX,
+	PMATRIX,
+	BMATRIX,
+	VMATRIX,
+	CAPITAL_VMATRIX,
+
+	// MISC
+	TO,
+	DISPLAY_MATH_OPEN,
+	DISPLAY_MATH_CLOSE,
+	INLINE_MATH_OPEN,
+	INLINE_MATH_CLOSE,
+	ESCAPED_BRACE_OPEN,
+	ESCAPED_BRACE_CLOSE,
+	NEWLINE,
+
+	COUNT,
+	NONE = 0xFFFF
+};
+
+/// @brief Semantic check of a command's arguments, see SemanticAnalyzer::RULE_DISPATCH
+enum class CommandRule : uint8_t
+{
+	NONE,
+	DIVISOR,         // \frac: denominator is not 0
+	RADICAND,        // \sqrt: radicand is not negative
+	LOGARITHM,       // \log \ln: argument is positive
+	INVERSE_TRIG,    // \arcsin \arccos: argument is in [-1, 1]
+	RECIPROCAL_TRIG, // \csc \cot: argument is not 0
+	BINOMIAL,        // \binom \choose: arguments are non-negative integers
+
+	COUNT
+};
+
 struct CommandInfo
 {
+	CommandId id = CommandId::NONE;               // CommandId: Dense index of the command in the registry
 	CommandType type = CommandType::UNKNOWN;      // CommandType: Type of command
 	TokenType type_override = TokenType::COMMAND; // TokenType: Override the current command type
 	int mandatory_args = 0;                       // int: # of mandatory args
 	int optional_args = 0;                        // int: # of optional args
 	bool allows_subscript = true;                 // bool: Allow subscripts
 	bool allows_superscript = true;               // bool: Allow superscripts
+	CommandRule rule = CommandRule::NONE;         // CommandRule: Semantic check run on the arguments
 };
 
 #endif
@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <string_view>
 
 #include "./latex_commands.hpp"
@@ -15,7 +16,24 @@ namespace LatexParser
 	/// @return const CommandInfo
 	const CommandInfo *find_command(std::string_view name)
 	{
-		auto it = LATEX_COMMANDS.find(name);
-		return it != LATEX_COMMANDS.end() ? &it->second : nullptr;
+		uint64_t hash = hash_command(name);
+		uint16_t index = LATEX_COMMANDS.slots[command_slot(hash, LATEX_COMMANDS.seeds[command_bucket(hash)])];
+
+		if (index == CommandTable::EMPTY_SLOT)
+			return nullptr;
+
+		const CommandEntry &entry = LATEX_COMMANDS.entries[index];
+		return entry.name == name ? &entry.info : nullptr;
+	}
+
+	/// @brief Get the CommandInfo for a CommandId
+	/// @param id: The id of the command
+	/// @return const CommandInfo* or nullptr for CommandId::NONE
+	const CommandInfo *get_command(CommandId id)
+	{
+		if (id >= CommandId::COUNT)
+			return nullptr;
+
+		return &LATEX_COMMANDS.entries[static_cast<size_t>(id)].info;
 	}
 }
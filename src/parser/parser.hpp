@@ -1,14 +1,21 @@
 #ifndef PARSER_HPP
 #define PARSER_HPP
 
+#include <array>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
-#include <unordered_map>
 #include <stdexcept>
 
 #include "../lexer/token_info.hpp"
+#include "../lexer/token_stream.hpp"
+#include "../lexer/utility/source_map.hpp"
+#include "../diagnostics/diagnostic.hpp"
 #include "../ast/ast_node.hpp"
 #include "../ast/ast_arena.hpp"
+#include "../ast/utility/symbol_table.hpp"
+#include "../core/utility/work_stealing_pool.hpp"
 
 // ======================
 // -- EXCEPTIONS
@@ -20,6 +27,7 @@ class ParseError : public std::runtime_error
 	public:
 		int line;
 		int column;
+		Diagnostic diagnostic;
 
 		/// @brief Construct a parse error
 		/// @param msg: Error message
@@ -27,6 +35,39 @@ class ParseError : public std::runtime_error
 		/// @param c: Column number where error occurred
 		ParseError(const std::string &msg, int l, int c)
 			: std::runtime_error(msg), line(l), column(c) {}
+
+		/// @brief Construct a parse error
+		/// @param msg: Error message
+		/// @param loc: Location where error occurred
+		/// @param diag: Structured form of the error
+		ParseError(const std::string &msg, SourceLocation loc, Diagnostic diag = {})
+			: std::runtime_error(msg), line(loc.line), column(loc.column), diagnostic(diag) {}
+};
+
+// ======================
+// -- ENUMS / STRUCTS
+// ======================
+
+/// @brief How tightly an infix operator binds, higher binds tighter
+enum class BindingPower : uint8_t
+{
+	NONE,
+	ASSIGNMENT,     // '=' '&', right-associative
+	RELATIONAL,     // '<' '>' '\leq' '\geq'
+	ADDITIVE,       // '+' '-' '\pm' '\mp'
+	MULTIPLICATIVE, // '*' '/'
+	POWER           // '^', right-associative
+};
+
+/// @brief Outcome of Parser::try_parse, no message is built
+struct ParseResult
+{
+	ASTNode *root = nullptr; // ASTNode*: Root of the AST, nullptr on failure or empty input
+	Diagnostic error;        // Diagnostic: DiagnosticCode::NONE on success
+
+	/// @brief Check if parsing succeeded
+	/// @return True on success
+	bool ok() const { return error.code == DiagnosticCode::NONE; }
 };
 
 // ======================
@@ -35,14 +76,63 @@ class ParseError : public std::runtime_error
 
 class Parser
 {
+	public:
+		static constexpr uint32_t DEFAULT_MAX_DEPTH = 1000;
+
+		/// @brief Callbacks of try_validate, every function gets context as its first argument
+		struct NodeHooks
+		{
+			void *context = nullptr;                        // void*: First argument of every callback
+			void (*built)(void *, ASTNode &) = nullptr;     // Called for every node as it is built
+			size_t (*mark)(void *) = nullptr;               // Called before building nodes the parser may drop
+			void (*drop)(void *, size_t) = nullptr;         // Nodes built since a mark are not part of the tree
+		};
+
 	private:
 		// ======================
 		// -- PARSER DATA
 		// ======================
 
 		ASTArena _arena;
-		std::vector<Token> _tokens;
-		size_t _position = 0;
+		TokenCursor _cursor;
+		SourceMap _source_map;
+		Diagnostic _failure;
+		std::vector<ASTNode *> _nodes; // std::vector: Stack of child lists still being parsed, see take_nodes
+		std::vector<NodeSpan> _rows;   // std::vector: Stack of environment rows still being parsed, see take_rows
+
+		/// @brief Infix operator still waiting for its right operand
+		struct PendingOperator
+		{
+			ASTNode *left;            // ASTNode*: Left operand
+			uint32_t token;           // uint32_t: Index of the operator token
+			BindingPower right_power; // BindingPower: Weakest operator the right operand may contain
+		};
+
+		std::vector<PendingOperator> _operators; // std::vector: Stack of pending infix operators, see parse_expression
+		uint32_t _depth = 0;                     // uint32_t: Nesting depth of the operand being parsed
+		uint32_t _max_depth = DEFAULT_MAX_DEPTH; // uint32_t: Deepest nesting before NESTING_TOO_DEEP
+
+		SymbolTable _symbols;                       // SymbolTable: Variable names, kept across inputs up to SymbolTable::RETAIN_LIMIT
+		std::vector<VariableNode *> _symbol_nodes;  // std::vector: Variables built by a worker, their ids index the worker's table
+		std::vector<SymbolId> _symbol_remap;        // std::vector: On a worker, its ids to the ids of the parser that owns it
+		bool _collect_symbols = false;              // bool: Record variables in _symbol_nodes, set on workers
+
+		NodeHooks _hooks;                  // NodeHooks: Callbacks for every node built, see try_validate
+		bool _discard_lines = false;       // bool: Rewind the arena after each top-level statement
+
+		std::vector<std::unique_ptr<Parser>> _workers;     // std::vector: One parser (and arena) per pool worker, see try_parse_parallel
+		std::vector<size_t> _boundaries;                   // std::vector: Token index where each slice starts, plus the END_OF_FILE index
+		std::vector<std::vector<ASTNode *>> _slice_lines;  // std::vector: Statements parsed from each slice
+
+		/// @brief Variables a worker built while parsing one slice
+		struct SliceSymbols
+		{
+			size_t worker; // size_t: Index into _workers
+			size_t first;  // size_t: First index into the worker's _symbol_nodes
+			size_t last;   // size_t: One past the last index
+		};
+
+		std::vector<SliceSymbols> _slice_symbols; // std::vector: Per slice, variables are renumbered in source order
 
 		// ======================
 		// -- DISPATCH DATA
@@ -50,7 +140,7 @@ class Parser
 
 		using PostfixHandler = ASTNode *(Parser::*)(ASTNode *);
 
-		static const std::unordered_map<TokenType, PostfixHandler> POSTFIX_DISPATCH;
+		static const std::array<PostfixHandler, 256> POSTFIX_DISPATCH; // std::array: Handler per TokenType, nullptr if not a postfix operator
 
 		// ======================
 		// -- FRIENDS
@@ -63,6 +153,21 @@ class Parser
 		// -- HELPER METHODS
 		// ======================
 
+		/// @brief Build a node in the arena and pass it to the node hook, if any
+		/// @tparam T: Node class
+		/// @param args: Constructor arguments
+		/// @return T*
+		template <typename T, typename... Args>
+			T *build_node(Args &&...args)
+			{
+				T *node = make_node<T>(_arena, std::forward<Args>(args)...);
+
+				if (_hooks.built)
+					_hooks.built(_hooks.context, *node);
+
+				return node;
+			}
+
 		/// @brief Check if at end of token stream
 		/// @return True if at end
 		[[nodiscard]] bool is_at_end() const;
@@ -71,6 +176,10 @@ class Parser
 		/// @return Current token before advancing
 		[[nodiscard]] Token current() const;
 
+		/// @brief Get the type of the current token without building it
+		/// @return TokenType
+		[[nodiscard]] TokenType current_type() const;
+
 		/// @brief Peek at next
 		/// @return Current token
 		[[nodiscard]] Token peek_next() const;
@@ -84,11 +193,32 @@ class Parser
 		/// @return True if current token matches type
 		bool match(TokenType type);
 
-		/// @brief Expect a specific token type or throw error
+		/// @brief Expect a specific token type or record a failure
 		/// @param type: Expected token type
-		/// @param msg: Optional message
-		/// @return The matched token
-		Token expect(TokenType type, const std::string &msg = "");
+		/// @param code: Diagnostic to record, UNEXPECTED_TOKEN reports the expected type
+		/// @return The matched token, or the current token (not consumed) on failure
+		Token expect(TokenType type, DiagnosticCode code = DiagnosticCode::UNEXPECTED_TOKEN);
+
+		/// @brief Check if a failure has been recorded
+		/// @return True if parsing failed
+		bool failed() const { return _failure.code != DiagnosticCode::NONE; }
+
+		/// @brief Record the first failure of this parse
+		/// @param code: What went wrong
+		/// @param token_index: Token the failure is reported at
+		/// @param operand: Second operand, see DiagnosticCode
+		/// @return nullptr, so handlers can return fail(...)
+		ASTNode *fail(DiagnosticCode code, size_t token_index, uint32_t operand = 0);
+
+		/// @brief Move the children pushed onto _nodes since start into the arena
+		/// @param start: Size of _nodes when the list was started
+		/// @return NodeSpan over the arena copy
+		NodeSpan take_nodes(size_t start);
+
+		/// @brief Move the rows pushed onto _rows since start into the arena
+		/// @param start: Size of _rows when the environment was started
+		/// @return ArenaSpan over the arena copy
+		ArenaSpan<NodeSpan> take_rows(size_t start);
 
 		// ======================
 		// -- PARSING METHODS
@@ -98,6 +228,15 @@ class Parser
 		/// @return Root node of the AST
 		ASTNode *parse_root();
 
+		/// @brief Parse top-level statements onto _nodes until a token index
+		/// @param end: Stop once the cursor reaches this index or END_OF_FILE
+		void parse_lines(size_t end);
+
+		/// @brief Split the tokens at top-level NEWLINE tokens into _boundaries
+		/// @param slices: # of slices wanted
+		/// @param min_tokens: Fewest tokens per slice
+		void find_boundaries(size_t slices, size_t min_tokens);
+
 		/// @brief Parse a environment
 		/// @return Environment AST node
 		ASTNode *parse_environment();
@@ -106,37 +245,26 @@ class Parser
 		/// @return LeftRight AST node
 		ASTNode *parse_left_right();
 
-		/// @brief Parse a statement
-		/// @return Statement AST node
-		ASTNode *parse_statement();
-
-		/// @brief Parse a assignment statement
-		/// @return AST node for assignment
-		ASTNode *parse_assignment();
-
-		/// @brief Parse relational expressions
-		/// @return AST node for relational expression
-		ASTNode *parse_relational();
-
-		/// @brief Parse a complete expression
+		/// @brief Parse an expression with a Pratt loop over INFIX_LOOKUP
+		/// @param min_power: Lowest binding power to accept, ASSIGNMENT for a full statement
 		/// @return AST node for expression
-		ASTNode *parse_expression();
-
-		/// @brief Parse a term
-		/// @return AST node for term
-		ASTNode *parse_term();
-
-		/// @brief Parse a power / exponentiation
-		/// @return AST node for power
-		ASTNode *parse_power();
+		ASTNode *parse_expression(BindingPower min_power = BindingPower::ASSIGNMENT);
 
 		/// @brief Parse a factor
+		/// @param implicit_mul: False for an operand of try_implicit_mul, which chains the next factor itself
 		/// @return AST node for factor
-		ASTNode *parse_prefix();
+		ASTNode *parse_prefix(bool implicit_mul = true);
+
+		/// @brief Build the node of a pending infix operator
+		/// @param pending: The operator and its left operand
+		/// @param right: Right operand
+		/// @return AssignNode or BinaryOpNode
+		ASTNode *make_operator(const PendingOperator &pending, ASTNode *right);
 
 		/// @brief Parse a postfix expression
+		/// @param implicit_mul: True to continue with try_implicit_mul
 		/// @return AST node for postfix
-		ASTNode *parse_postfix();
+		ASTNode *parse_postfix(bool implicit_mul);
 
 		/// @brief Parse a primary expression
 		/// @return AST node for primary
@@ -160,7 +288,7 @@ class Parser
 		/// @return A UnaryOpNode representing the factorial
 		ASTNode *parse_factorial(ASTNode *left);
 
-		/// @brief Try to parse implicit multiplication
+		/// @brief Try to parse implicit multiplication, x y z builds x * (y * z)
 		/// @param left: Left AST node
 		/// @return AST node for implicit multiplication or left node if no implicit multiplication
 		ASTNode *try_implicit_mul(ASTNode *left);
@@ -179,10 +307,15 @@ class Parser
 		// -- UTILITY
 		// ======================
 
-		/// @brief Get string representation of a token
-		/// @param token: The token to represent
-		/// @return std::string
-		std::string token_repr(const Token &token) const;
+		/// @brief Line and column of a source offset, only called when reporting an error
+		/// @param offset: Byte offset into the source
+		/// @return SourceLocation
+		SourceLocation locate(uint32_t offset) const;
+
+		/// @brief Build the exception thrown by parse() for a failure
+		/// @param failure: The recorded failure
+		/// @return ParseError
+		ParseError make_error(const Diagnostic &failure) const;
 
 	public:
 		// ======================
@@ -193,17 +326,85 @@ class Parser
 		Parser() = default;
 
 		/// @brief Parser constructor
-		/// @param toks: Vector of tokens to parse
-		Parser(std::vector<Token> toks) : _tokens(std::move(toks)) {}
+		/// @param toks: Tokens to parse, borrowed (not copied), must end with END_OF_FILE
+		/// @note toks (and the text its tokens point into) must outlive the parser and the AST it returns
+		Parser(const TokenStream &toks) : _cursor(toks), _source_map(toks.source)
+		{
+			_nodes.reserve(64);
+			_rows.reserve(16);
+			_operators.reserve(16);
+		}
+
+		/// @brief Prevent borrowing a temporary token stream
+		Parser(TokenStream &&) = delete;
 
 		// ======================
 		// -- PUBLIC METHODS
 		// ======================
 
+		/// @brief Point the parser at new tokens, freeing the previous AST but keeping its memory
+		/// @param toks: Tokens to parse, borrowed (not copied), must end with END_OF_FILE
+		/// @note Every node returned before the reset is invalidated
+		void reset(const TokenStream &toks);
+
+		/// @brief Prevent borrowing a temporary token stream
+		void reset(TokenStream &&) = delete;
+
+		/// @brief Limit how deeply groups, scripts, calls and command arguments may nest
+		/// @param depth: Deepest nesting, deeper input fails with NESTING_TOO_DEEP instead of exhausting the stack
+		void set_max_depth(uint32_t depth) { _max_depth = depth; }
+
+		/// @brief Deepest nesting allowed
+		/// @return uint32_t
+		uint32_t max_depth() const { return _max_depth; }
+
+		/// @brief Memory usage of the AST arena
+		/// @return ASTArena::ArenaStats
+		ASTArena::ArenaStats arena_stats() const { return _arena.stats(); }
+
+		/// @brief Names of the VariableNode symbols of every input since the table was last cleared
+		/// @return const SymbolTable&, ids stay valid across resets until the table passes SymbolTable::RETAIN_LIMIT
+		const SymbolTable &symbols() const { return _symbols; }
+
+		/// @brief Line and column lookups for the text of the tokens being parsed
+		/// @return const SourceMap&, follows the text on each reset
+		const SourceMap &source_map() const { return _source_map; }
+
+		/// @brief Choose the kernel the SourceMap collects newlines with
+		/// @param kernel: The character-class scanning kernel, AUTO picks by CPU feature
+		/// @note Takes effect on the next reset
+		void set_scan_kernel(CharScan::Kernel kernel) { _source_map = SourceMap(std::string_view(), kernel); }
+
 		/// @brief Parse tokens into an AST
 		/// @return Root node of the AST
 		/// @throws ParseError if parsing fails
 		ASTNode *parse();
+
+		/// @brief Parse tokens into an AST without throwing
+		/// @return ParseResult with the root, or the Diagnostic of the first error
+		/// @note No message is formatted, see render_diagnostic
+		ParseResult try_parse();
+
+		/// @brief Parse tokens without keeping the AST, passing every node to a hook as it is built
+		/// @param hooks: built is called once per node, children before their parent, in the order a post-order walk
+		/// visits them; drop undoes every built call since a mark for nodes left out of the tree
+		/// @return ParseResult whose root is always nullptr, the error matches try_parse()
+		/// @note Each top-level statement is freed once parsed, the hooks must not keep nodes
+		ParseResult try_validate(const NodeHooks &hooks);
+
+		/// @brief Parse tokens into an AST, parsing top-level lines concurrently
+		/// @param pool: Workers to parse on, each gets its own parser and arena
+		/// @param min_slice_tokens: Fewest tokens per slice, inputs smaller than two slices are parsed serially
+		/// @return Root node of the AST, the same tree parse() builds
+		/// @throws ParseError if parsing fails, with the diagnostic parse() reports
+		ASTNode *parse_parallel(WorkStealingPool &pool, size_t min_slice_tokens = 4096);
+
+		/// @brief Parse tokens into an AST without throwing, parsing top-level lines concurrently
+		/// @param pool: Workers to parse on, each gets its own parser and arena
+		/// @param min_slice_tokens: Fewest tokens per slice, inputs smaller than two slices are parsed serially
+		/// @return ParseResult identical to try_parse()
+		/// @note A slice that fails or does not end at its boundary makes the whole input fall back to try_parse()
+		ParseResult try_parse_parallel(WorkStealingPool &pool, size_t min_slice_tokens = 4096);
 };
 
 #endif
@@ -1,5 +1,7 @@
 #include <string>
 #include <array>
+#include <atomic>
+#include <algorithm>
 
 #include "./parser.hpp"
 #include "../lexer/token_info.hpp"
@@ -29,50 +31,103 @@ namespace
 		}
 	};
 
-	struct ExpressionOpTable
+	/// @brief Infix binding power and operator character per TokenType
+	struct BindingPowerTable
 	{
-		std::array<char, 256> data{};
+		std::array<BindingPower, 256> power{};
+		std::array<char, 256> op{};
 
-		constexpr ExpressionOpTable()
+		constexpr BindingPowerTable()
 		{
 			for (int i = 0; i < 256; i++)
-				data[i] = '\0';
+			{
+				power[i] = BindingPower::NONE;
+				op[i] = '\0';
+			}
+
+			map_infix(TokenType::EQUAL, BindingPower::ASSIGNMENT, '=');
+			map_infix(TokenType::ALIGNMENT, BindingPower::ASSIGNMENT, '&');
+
+			map_infix(TokenType::LESS, BindingPower::RELATIONAL, '<');
+			map_infix(TokenType::GREATER, BindingPower::RELATIONAL, '>');
+			map_infix(TokenType::LESS_EQUAL, BindingPower::RELATIONAL, 'L');
+			map_infix(TokenType::GREATER_EQUAL, BindingPower::RELATIONAL, 'G');
 
-			data[static_cast<size_t>(TokenType::PLUS)] = '+';
-			data[static_cast<size_t>(TokenType::MINUS)] = '-';
-			data[static_cast<size_t>(TokenType::PLUS_MINUS)] = 'P';
-			data[static_cast<size_t>(TokenType::MINUS_PLUS)] = 'M';
+			map_infix(TokenType::PLUS, BindingPower::ADDITIVE, '+');
+			map_infix(TokenType::MINUS, BindingPower::ADDITIVE, '-');
+			map_infix(TokenType::PLUS_MINUS, BindingPower::ADDITIVE, 'P');
+			map_infix(TokenType::MINUS_PLUS, BindingPower::ADDITIVE, 'M');
+
+			map_infix(TokenType::STAR, BindingPower::MULTIPLICATIVE, '*');
+			map_infix(TokenType::SLASH, BindingPower::MULTIPLICATIVE, '/');
+
+			map_infix(TokenType::CARET, BindingPower::POWER, '^');
+			map_infix(TokenType::SUPERSCRIPT, BindingPower::POWER, '^');
+		}
+
+		/// @brief Map a token to an infix operator
+		/// @param type: The operator token
+		/// @param bp: How tightly it binds
+		/// @param c: Operator character stored in BinaryOpNode
+		constexpr void map_infix(TokenType type, BindingPower bp, char c)
+		{
+			power[static_cast<size_t>(type)] = bp;
+			op[static_cast<size_t>(type)] = c;
 		}
 	};
 
-	struct RelationalOpTable
+	/// @brief Check if operators of a binding power group to the right
+	/// @param bp: Binding power
+	/// @return True for ASSIGNMENT and POWER
+	constexpr bool is_right_assoc(BindingPower bp)
+	{
+		return bp == BindingPower::ASSIGNMENT || bp == BindingPower::POWER;
+	}
+
+	/// @brief Nesting change per TokenType, top-level NEWLINE tokens sit at depth 0
+	struct NestingTable
 	{
-		std::array<char, 256> data{};
+		std::array<int8_t, 256> delta{};
 
-		constexpr RelationalOpTable()
+		constexpr NestingTable()
 		{
-			for (int i = 0; i < 256; i++)
-				data[i] = '\0';
+			map_pair(TokenType::BRACE_OPEN, TokenType::BRACE_CLOSE);
+			map_pair(TokenType::ESCAPED_BRACE_OPEN, TokenType::ESCAPED_BRACE_CLOSE);
+			map_pair(TokenType::BRACKET_OPEN, TokenType::BRACKET_CLOSE);
+			map_pair(TokenType::PAREN_OPEN, TokenType::PAREN_CLOSE);
+			map_pair(TokenType::DISPLAY_MATH_OPEN, TokenType::DISPLAY_MATH_CLOSE);
+			map_pair(TokenType::INLINE_MATH_OPEN, TokenType::INLINE_MATH_CLOSE);
+			map_pair(TokenType::ENV_BEGIN, TokenType::ENV_END);
+			map_pair(TokenType::LEFT_WRAP, TokenType::RIGHT_WRAP);
+		}
 
-			data[static_cast<size_t>(TokenType::LESS)] = '<';
-			data[static_cast<size_t>(TokenType::GREATER)] = '>';
-			data[static_cast<size_t>(TokenType::LESS_EQUAL)] = 'L';
-			data[static_cast<size_t>(TokenType::GREATER_EQUAL)] = 'G';
+		/// @brief Map an opening and closing token
+		/// @param open: Token that nests
+		/// @param close: Token that un-nests
+		constexpr void map_pair(TokenType open, TokenType close)
+		{
+			delta[static_cast<size_t>(open)] = 1;
+			delta[static_cast<size_t>(close)] = -1;
 		}
 	};
 
 	static constexpr ImplicitMulTable MUL_LOOKUP;
-	static constexpr ExpressionOpTable EXPR_OP_LOOKUP;
-	static constexpr RelationalOpTable REL_OP_LOOKUP;
+	static constexpr NestingTable NESTING_LOOKUP;
+	static constexpr BindingPowerTable INFIX_LOOKUP;
 }
 
-const std::unordered_map<TokenType, Parser::PostfixHandler> Parser::POSTFIX_DISPATCH = {
-	{TokenType::PAREN_OPEN, &Parser::try_function_call},
-	{TokenType::BRACE_OPEN, &Parser::try_braced_call},
-	{TokenType::ESCAPED_BRACE_OPEN, &Parser::try_braced_call},
-	{TokenType::SUBSCRIPT, &Parser::parse_subsup},
-	{TokenType::SUPERSCRIPT, &Parser::parse_subsup},
-	{TokenType::FACTORIAL, &Parser::parse_factorial}};
+const std::array<Parser::PostfixHandler, 256> Parser::POSTFIX_DISPATCH = []() constexpr {
+	std::array<PostfixHandler, 256> table{};
+
+	table[static_cast<size_t>(TokenType::PAREN_OPEN)] = &Parser::try_function_call;
+	table[static_cast<size_t>(TokenType::BRACE_OPEN)] = &Parser::try_braced_call;
+	table[static_cast<size_t>(TokenType::ESCAPED_BRACE_OPEN)] = &Parser::try_braced_call;
+	table[static_cast<size_t>(TokenType::SUBSCRIPT)] = &Parser::parse_subsup;
+	table[static_cast<size_t>(TokenType::SUPERSCRIPT)] = &Parser::parse_subsup;
+	table[static_cast<size_t>(TokenType::FACTORIAL)] = &Parser::parse_factorial;
+
+	return table;
+}();
 
 // ======================
 // -- HELPER IMPL.
@@ -82,31 +137,38 @@ const std::unordered_map<TokenType, Parser::PostfixHandler> Parser::POSTFIX_DISP
 /// @return True if at end
 bool Parser::is_at_end() const
 {
-	return _tokens[_position].Type == TokenType::END_OF_FILE;
+	return _cursor.type() == TokenType::END_OF_FILE;
 }
 
 /// @brief Get the current token
 /// @return Current token before advancing
 Token Parser::current() const
 {
-	return _tokens[_position];
+	return _cursor.token();
+}
+
+/// @brief Get the type of the current token without building it
+/// @return TokenType
+TokenType Parser::current_type() const
+{
+	return _cursor.type();
 }
 
 /// @brief Peek at next
 /// @return Current token
 Token Parser::peek_next() const
 {
-	if (_position + 1 >= _tokens.size())
-		return _tokens.back();
-
-	return _tokens[_position + 1];
+	return _cursor.peek();
 }
 
 /// @brief Consume the current token
 /// @return Token
 Token Parser::consume()
 {
-	return _tokens[_position++];
+	Token token = _cursor.token();
+	_cursor.advance();
+
+	return token;
 }
 
 /// @brief Check if current token matches given type
@@ -117,73 +179,342 @@ bool Parser::match(TokenType type)
 	if (is_at_end()) [[unlikely]]
 		return false;
 
-	return current().Type == type;
+	return current_type() == type;
 }
 
-/// @brief Expect a specific token type or throw error
+/// @brief Expect a specific token type or record a failure
 /// @param type: Expected token type
-/// @param msg: Optional message
-/// @return The matched token
-Token Parser::expect(TokenType type, const std::string &msg)
+/// @param code: Diagnostic to record, UNEXPECTED_TOKEN reports the expected type
+/// @return The matched token, or the current token (not consumed) on failure
+Token Parser::expect(TokenType type, DiagnosticCode code)
 {
-	if (_tokens[_position].Type != type)
+	if (current_type() != type) [[unlikely]]
 	{
-		std::string error_msg = msg.empty()
-			? "Expected Token Type: (" + std::to_string(static_cast<int>(type)) + ")"
-			: std::string(msg);
+		fail(code, _cursor.position(), static_cast<uint32_t>(type));
+		return current();
+	}
 
-		Token err_tok = current();
+	return consume();
+}
 
-		throw ParseError(error_msg + " but found " + token_repr(err_tok),
-				err_tok.line, err_tok.column);
+/// @brief Record the first failure of this parse
+/// @param code: What went wrong
+/// @param token_index: Token the failure is reported at
+/// @param operand: Second operand, see DiagnosticCode
+/// @return nullptr, so handlers can return fail(...)
+ASTNode *Parser::fail(DiagnosticCode code, size_t token_index, uint32_t operand)
+{
+	if (_failure.code == DiagnosticCode::NONE)
+	{
+		_failure.code = code;
+		_failure.offset = _cursor.stream().offsets[token_index];
+		_failure.operands[0] = static_cast<uint32_t>(token_index);
+		_failure.operands[1] = operand;
 	}
 
-	return consume();
+	return nullptr;
 }
 
-/// @brief Get string representation of a token
-/// @param token: The token to represent
-/// @return std::string
-std::string Parser::token_repr(const Token &token) const
+/// @brief Move the children pushed onto _nodes since start into the arena
+/// @param start: Size of _nodes when the list was started
+/// @return NodeSpan over the arena copy
+NodeSpan Parser::take_nodes(size_t start)
 {
-	return "'" + std::string(token.Value) + "' (" + std::to_string(static_cast<int>(token.Type)) + ")";
+	NodeSpan span = _arena.copy_span(_nodes.data() + start, _nodes.size() - start);
+	_nodes.resize(start);
+	return span;
+}
+
+/// @brief Move the rows pushed onto _rows since start into the arena
+/// @param start: Size of _rows when the environment was started
+/// @return ArenaSpan over the arena copy
+ArenaSpan<NodeSpan> Parser::take_rows(size_t start)
+{
+	ArenaSpan<NodeSpan> span = _arena.copy_span(_rows.data() + start, _rows.size() - start);
+	_rows.resize(start);
+	return span;
+}
+
+/// @brief Line and column of a source offset, only called when reporting an error
+/// @param offset: Byte offset into the source
+/// @return SourceLocation
+SourceLocation Parser::locate(uint32_t offset) const
+{
+	return _source_map.locate(offset);
+}
+
+/// @brief Build the exception thrown by parse() for a failure
+/// @param failure: The recorded failure
+/// @return ParseError
+ParseError Parser::make_error(const Diagnostic &failure) const
+{
+	return ParseError(render_diagnostic(failure, _cursor.stream(), _source_map), locate(failure.offset), failure);
 }
 
 // ======================
 // -- PARSING IMPL.
 // ======================
 
+/// @brief Point the parser at new tokens, freeing the previous AST but keeping its memory
+/// @param toks: Tokens to parse, borrowed (not copied), must end with END_OF_FILE
+void Parser::reset(const TokenStream &toks)
+{
+	_arena.reset();
+	_cursor = TokenCursor(toks);
+	_source_map.reset(toks.source);
+	_failure = {};
+	_depth = 0;
+	_symbol_nodes.clear();
+
+	// Ids stay stable across inputs, unless a stream of distinct names would grow the table without bound
+	if (_symbols.size() > SymbolTable::RETAIN_LIMIT)
+		_symbols.clear();
+
+	_nodes.reserve(64);
+	_rows.reserve(16);
+	_operators.reserve(16);
+}
+
 /// @brief Parse tokens into an AST
 /// @return Root node of the AST
 /// @throws ParseError if parsing fails
 ASTNode *Parser::parse()
 {
-	auto node = parse_root();
+	ParseResult result = try_parse();
+
+	if (!result.ok())
+		throw make_error(result.error);
+
+	return result.root;
+}
+
+/// @brief Parse tokens into an AST without throwing
+/// @return ParseResult with the root, or the error code and token index
+ParseResult Parser::try_parse()
+{
+	_nodes.clear();
+	_rows.clear();
+	_operators.clear();
+	_depth = 0;
+
+	ASTNode *node = parse_root();
+
+	if (!failed() && !is_at_end())
+		fail(DiagnosticCode::TRAILING_TOKEN, _cursor.position());
+
+	ParseResult result;
+
+	if (failed())
+		result.error = _failure;
+	else
+		result.root = node;
+
+	return result;
+}
+
+/// @brief Parse tokens without keeping the AST, passing every node to a hook as it is built
+/// @param hooks: built is called once per node, children before their parent; drop undoes the calls since a mark
+/// @return ParseResult whose root is always nullptr, the error matches try_parse()
+ParseResult Parser::try_validate(const NodeHooks &hooks)
+{
+	_hooks = hooks;
+	_discard_lines = true;
 
-	if (!is_at_end())
+	ParseResult result = try_parse();
+
+	_hooks = {};
+	_discard_lines = false;
+
+	return result;
+}
+
+/// @brief Parse tokens into an AST, parsing top-level lines concurrently
+/// @param pool: Workers to parse on, each gets its own parser and arena
+/// @param min_slice_tokens: Fewest tokens per slice, inputs smaller than two slices are parsed serially
+/// @return Root node of the AST, the same tree parse() builds
+/// @throws ParseError if parsing fails, with the diagnostic parse() reports
+ASTNode *Parser::parse_parallel(WorkStealingPool &pool, size_t min_slice_tokens)
+{
+	ParseResult result = try_parse_parallel(pool, min_slice_tokens);
+
+	if (!result.ok())
+		throw make_error(result.error);
+
+	return result.root;
+}
+
+/// @brief Parse tokens into an AST without throwing, parsing top-level lines concurrently
+/// @param pool: Workers to parse on, each gets its own parser and arena
+/// @param min_slice_tokens: Fewest tokens per slice, inputs smaller than two slices are parsed serially
+/// @return ParseResult identical to try_parse()
+ParseResult Parser::try_parse_parallel(WorkStealingPool &pool, size_t min_slice_tokens)
+{
+	const TokenStream &tokens = _cursor.stream();
+	size_t start = _cursor.position();
+
+	// A few slices per worker so stealing can even out uneven lines
+	find_boundaries(pool.size() * 4, min_slice_tokens);
+
+	size_t slices = _boundaries.size() - 1;
+
+	if (slices < 2)
+		return try_parse();
+
+	while (_workers.size() < pool.size())
+		_workers.push_back(std::make_unique<Parser>());
+
+	for (auto &worker : _workers)
+	{
+		worker->reset(tokens);
+		worker->_max_depth = _max_depth;
+		worker->_collect_symbols = true;
+	}
+
+	if (_slice_lines.size() < slices)
+	{
+		_slice_lines.resize(slices);
+		_slice_symbols.resize(slices);
+	}
+
+	std::atomic<bool> split_failed{false};
+
+	pool.parallel_for(slices, 1, [&](size_t w, size_t begin, size_t end) {
+			Parser &worker = *_workers[w];
+
+			for (size_t slice = begin; slice < end && !split_failed.load(std::memory_order_relaxed); slice++)
+			{
+				size_t slice_end = _boundaries[slice + 1];
+
+				size_t first_symbol = worker._symbol_nodes.size();
+
+				worker._cursor.seek(_boundaries[slice]);
+				worker._nodes.clear();
+				worker.parse_lines(slice_end);
+
+				// The serial parse would have read past the boundary, so the split is not valid
+				if (worker.failed() || worker._cursor.position() != slice_end)
+				{
+					split_failed.store(true, std::memory_order_relaxed);
+					return;
+				}
+
+				_slice_lines[slice].assign(worker._nodes.begin(), worker._nodes.end());
+				_slice_symbols[slice] = {w, first_symbol, worker._symbol_nodes.size()};
+			}
+			});
+
+	// Errors are rare, the serial parse reports them exactly
+	if (split_failed.load())
+	{
+		_cursor.seek(start);
+		return try_parse();
+	}
+
+	// Move every worker's variables to ids of this parser's table, slice by slice so names are
+	// interned in source order and get the ids the serial parse gives them
+	for (auto &worker : _workers)
+		worker->_symbol_remap.assign(worker->_symbols.size(), SymbolTable::NO_SYMBOL);
+
+	for (size_t slice = 0; slice < slices; slice++)
+	{
+		const SliceSymbols &range = _slice_symbols[slice];
+		Parser &worker = *_workers[range.worker];
+
+		for (size_t i = range.first; i < range.last; i++)
+		{
+			VariableNode *node = worker._symbol_nodes[i];
+			SymbolId &id = worker._symbol_remap[node->symbol];
+
+			if (id == SymbolTable::NO_SYMBOL)
+				id = _symbols.intern(worker._symbols.name(node->symbol));
+
+			node->symbol = id;
+		}
+	}
+
+	_nodes.clear();
+	_rows.clear();
+
+	for (size_t slice = 0; slice < slices; slice++)
+		_nodes.insert(_nodes.end(), _slice_lines[slice].begin(), _slice_lines[slice].end());
+
+	_cursor.seek(_boundaries.back());
+
+	ParseResult result;
+
+	if (_nodes.size() == 1)
+		result.root = _nodes[0];
+	else if (!_nodes.empty())
+		result.root = make_node<SequenceNode>(_arena, take_nodes(0), _nodes[0]->offset);
+
+	return result;
+}
+
+/// @brief Split the tokens at top-level NEWLINE tokens into _boundaries
+/// @param slices: # of slices wanted
+/// @param min_tokens: Fewest tokens per slice
+void Parser::find_boundaries(size_t slices, size_t min_tokens)
+{
+	const TokenStream &tokens = _cursor.stream();
+	size_t start = _cursor.position();
+	size_t eof = tokens.size() - 1;
+	size_t slice_tokens = std::max(min_tokens, (eof - start) / std::max<size_t>(1, slices));
+
+	_boundaries.clear();
+	_boundaries.push_back(start);
+
+	int depth = 0;
+
+	for (size_t i = start; i < eof; i++)
 	{
-		Token current_token = current();
-
-		throw ParseError(
-				"Unexpected token " + token_repr(current_token) +
-				" after complete expression @" +
-				std::to_string(current_token.line) + ':' +
-				std::to_string(current_token.column),
-				current_token.line,
-				current_token.column);
+		TokenType type = tokens.types[i];
+
+		// An unmatched close can only fail the serial parse, which is checked afterwards
+		depth = std::max(0, depth + NESTING_LOOKUP.delta[static_cast<size_t>(type)]);
+
+		if (type == TokenType::NEWLINE && depth == 0 && i - _boundaries.back() >= slice_tokens)
+			_boundaries.push_back(i);
 	}
 
-	return node;
+	// The last slice must be long enough to be worth its own task
+	if (_boundaries.size() > 1 && eof - _boundaries.back() < slice_tokens / 2)
+		_boundaries.pop_back();
+
+	_boundaries.push_back(eof);
 }
 
 /// @brief Parse root of the AST
 /// @return Root node of the AST
 ASTNode *Parser::parse_root()
 {
-	std::vector<ASTNode *> lines;
-	lines.reserve(8);
+	size_t start = _nodes.size();
 
-	while (!is_at_end())
+	parse_lines(SIZE_MAX);
+
+	if (failed())
+		return nullptr;
+
+	size_t count = _nodes.size() - start;
+
+	if (count == 0)
+		return nullptr;
+
+	if (count == 1)
+	{
+		ASTNode *line = _nodes.back();
+		_nodes.pop_back();
+		return line;
+	}
+
+	NodeSpan lines = take_nodes(start);
+	return build_node<SequenceNode>(lines, lines[0]->offset);
+}
+
+/// @brief Parse top-level statements onto _nodes until a token index
+/// @param end: Stop once the cursor reaches this index or END_OF_FILE
+void Parser::parse_lines(size_t end)
+{
+	while (!is_at_end() && _cursor.position() < end)
 	{
 		if (match(TokenType::NEWLINE) || match(TokenType::SPACING))
 		{
@@ -191,27 +522,37 @@ ASTNode *Parser::parse_root()
 			continue;
 		}
 
-		lines.push_back(parse_statement());
-	}
+		ASTArena::Marker line_start = _arena.mark();
+		ASTNode *line = parse_expression();
 
-	if (lines.empty())
-		return nullptr;
+		if (failed())
+			return;
 
-	return lines.size() > 1
-		? make_node<SequenceNode>(_arena, lines, lines[0]->line, lines[0]->column)
-		: lines[0];
+		// The hook has seen every node of the line, nothing refers to them any more
+		if (_discard_lines)
+		{
+			_arena.rewind(line_start);
+			continue;
+		}
+
+		_nodes.push_back(line);
+	}
 }
 
 /// @brief Parse a environment
 /// @return Environment AST node
 ASTNode *Parser::parse_environment()
 {
+	size_t begin_index = _cursor.position();
 	Token current_token = consume();
 
 	expect(TokenType::BRACE_OPEN);
-	std::string name = std::string(expect(TokenType::IDENTIFIER).Value);
+	std::string_view name = expect(TokenType::IDENTIFIER).Value;
 	expect(TokenType::BRACE_CLOSE);
 
+	if (failed())
+		return nullptr;
+
 	if (match(TokenType::BRACE_OPEN))
 	{
 		consume();
@@ -220,10 +561,14 @@ ASTNode *Parser::parse_environment()
 			consume();
 
 		expect(TokenType::BRACE_CLOSE);
+
+		if (failed())
+			return nullptr;
 	}
 
-	std::vector<std::vector<ASTNode *>> body;
-	std::vector<ASTNode *> current_line;
+	size_t rows_start = _rows.size();
+	size_t line_start = _nodes.size();
+	size_t row_mark = _hooks.mark ? _hooks.mark(_hooks.context) : 0;
 
 	while (!is_at_end())
 	{
@@ -233,18 +578,35 @@ ASTNode *Parser::parse_environment()
 
 			expect(TokenType::BRACE_OPEN);
 
-			if (expect(TokenType::IDENTIFIER).Value == name)
+			if (failed())
+				return nullptr;
+
+			Token close_name = expect(TokenType::IDENTIFIER);
+
+			if (failed())
+				return nullptr;
+
+			if (close_name.Value == name)
 			{
 				expect(TokenType::BRACE_CLOSE);
-				if (!current_line.empty())
-					body.push_back(std::move(current_line));
+
+				if (failed())
+					return nullptr;
+
+				if (_nodes.size() > line_start)
+					_rows.push_back(take_nodes(line_start));
 				break;
 			}
 
-			throw ParseError("Mismatched environment closure", current_token.line, current_token.column);
+			return fail(DiagnosticCode::MISMATCHED_ENVIRONMENT, begin_index);
 		}
 
-		current_line.push_back(parse_assignment());
+		ASTNode *cell = parse_expression();
+
+		if (failed())
+			return nullptr;
+
+		_nodes.push_back(cell);
 
 		if (match(TokenType::ALIGNMENT))
 		{
@@ -253,212 +615,189 @@ ASTNode *Parser::parse_environment()
 		else if (match(TokenType::NEWLINE))
 		{
 			consume();
-			body.push_back(std::move(current_line));
-			current_line.clear();
+			_rows.push_back(take_nodes(line_start));
+
+			if (_hooks.mark)
+				row_mark = _hooks.mark(_hooks.context);
 		}
 	}
 
-	return make_node<EnvironmentNode>(_arena, name, body, current_token.line, current_token.column);
+	// An environment left open at END_OF_FILE drops its unfinished row
+	if (_nodes.size() > line_start && _hooks.drop)
+		_hooks.drop(_hooks.context, row_mark);
+
+	_nodes.resize(line_start);
+
+	return build_node<EnvironmentNode>(name, take_rows(rows_start), current_token.offset);
 }
 
 /// @brief Parse a left-right construct
 /// @return LeftRight AST node
 ASTNode *Parser::parse_left_right()
 {
-	Token current_token = current();
-
-	int start_line = current_token.line;
-	int start_col = current_token.column;
+	size_t left_index = _cursor.position();
+	uint32_t start = current().offset;
 
 	consume();
 
 	Token left_delim = consume();
 
-	ASTNode *inner = parse_assignment();
+	ASTNode *inner = parse_expression();
 
-	if (!match(TokenType::RIGHT_WRAP))
-	{
-		Token err_token = current();
+	if (failed())
+		return nullptr;
 
-		throw ParseError(
-				"Missing \\right to match \\left @" +
-				std::to_string(start_line) + ":" + std::to_string(start_col),
-				err_token.line,
-				err_token.column);
-	}
+	if (!match(TokenType::RIGHT_WRAP))
+		return fail(DiagnosticCode::MISSING_RIGHT, _cursor.position(), static_cast<uint32_t>(left_index));
 
 	consume();
 
 	Token right_delim = consume();
 
-	return make_node<LeftRightNode>(
-			_arena,
-			std::string(left_delim.Value),
-			std::string(right_delim.Value),
+	return build_node<LeftRightNode>(
+			left_delim.Value,
+			right_delim.Value,
 			inner,
-			start_line,
-			start_col);
-}
-
-/// @brief Parse a statement
-/// @return Statement AST node
-ASTNode *Parser::parse_statement()
-{
-	return parse_assignment();
+			start);
 }
 
 // ======================
 // -- PRECEDENCE IMPL.
 // ======================
 
-/// @brief Parse a assignment statement
-/// @return AST node for assignment
-ASTNode *Parser::parse_assignment()
+/// @brief Parse an expression whose infix operators bind at least as tightly as min_power (Pratt)
+/// @param min_power: Lowest binding power to accept
+/// @return AST node for expression
+ASTNode *Parser::parse_expression(BindingPower min_power)
 {
-	ASTNode *left;
-
-	if (match(TokenType::EQUAL) || match(TokenType::ALIGNMENT))
-	{
-		left = make_node<SymbolNode>(_arena, "", current().line, current().column);
-	}
-	else
-	{
-		left = parse_relational();
-	}
+	// Operators waiting for their right operand live on _operators instead of the call stack,
+	// so 'a^b^c^...' and 'a=b=c=...' chains of any length use constant stack
+	size_t base = _operators.size();
+	BindingPower operand_power = min_power;
 
-	if (match(TokenType::EQUAL) || match(TokenType::ALIGNMENT))
+	while (true)
 	{
-		Token op = consume();
-		auto right = parse_assignment();
+		ASTNode *operand;
 
-		if (op.Type == TokenType::EQUAL)
-			return make_node<AssignNode>(_arena, left, right, op.line, op.column);
+		// A leading '=' / '&' gets an empty left-hand side, only at assignment level
+		if (operand_power == BindingPower::ASSIGNMENT && (match(TokenType::EQUAL) || match(TokenType::ALIGNMENT)))
+		{
+			operand = build_node<SymbolNode>("", current().offset);
+		}
 		else
-			return make_node<BinaryOpNode>(_arena, '&', left, right, op.line, op.column);
-	}
+		{
+			operand = parse_prefix();
 
-	return left;
-}
+			if (failed())
+			{
+				_operators.resize(base);
+				return nullptr;
+			}
+		}
 
-/// @brief Parse relational expressions
-/// @return AST node for relational expression
-ASTNode *Parser::parse_relational()
-{
-	auto left = parse_expression();
+		size_t type = static_cast<size_t>(current_type());
+		BindingPower power = INFIX_LOOKUP.power[type];
 
-	TokenType current_token_type = current().Type;
+		// Reduce every pending operator that binds tighter than the next one
+		while (_operators.size() > base && (power == BindingPower::NONE || power < _operators.back().right_power))
+		{
+			PendingOperator pending = _operators.back();
+			_operators.pop_back();
+			operand = make_operator(pending, operand);
+		}
 
-	while (current_token_type == TokenType::LESS || current_token_type == TokenType::GREATER ||
-			current_token_type == TokenType::LESS_EQUAL || current_token_type == TokenType::GREATER_EQUAL)
-	{
-		Token op = consume();
-		auto right = parse_expression();
+		if (power == BindingPower::NONE || power < min_power)
+			return operand;
 
-		char oper = REL_OP_LOOKUP.data[static_cast<size_t>(op.Type)];
+		size_t op_index = _cursor.position();
+		consume();
 
-		left = make_node<BinaryOpNode>(_arena, oper, left, right, op.line, op.column);
+		BindingPower right_power = is_right_assoc(power)
+			? power
+			: static_cast<BindingPower>(static_cast<uint8_t>(power) + 1);
 
-		current_token_type = current().Type;
+		_operators.push_back({operand, static_cast<uint32_t>(op_index), right_power});
+		operand_power = right_power;
 	}
-
-	return left;
 }
 
-/// @brief Parse a complete expression
-/// @return AST node for expression
-ASTNode *Parser::parse_expression()
+/// @brief Build the node of a pending infix operator
+/// @param pending: The operator and its left operand
+/// @param right: Right operand
+/// @return AssignNode or BinaryOpNode
+ASTNode *Parser::make_operator(const PendingOperator &pending, ASTNode *right)
 {
-	auto left = parse_term();
-
-	while (match(TokenType::PLUS) || match(TokenType::MINUS) || match(TokenType::PLUS_MINUS) || match(TokenType::MINUS_PLUS))
-	{
-		Token op = consume();
-		auto right = parse_term();
-
-		char oper = EXPR_OP_LOOKUP.data[static_cast<size_t>(op.Type)];
+	const TokenStream &tokens = _cursor.stream();
+	TokenType type = tokens.types[pending.token];
+	uint32_t offset = tokens.offsets[pending.token];
 
-		left = make_node<BinaryOpNode>(_arena, oper, left, right, op.line, op.column);
-	}
+	if (type == TokenType::EQUAL)
+		return build_node<AssignNode>(pending.left, right, offset);
 
-	return left;
+	return build_node<BinaryOpNode>(INFIX_LOOKUP.op[static_cast<size_t>(type)], pending.left, right, offset);
 }
 
-/// @brief Parse a term
-/// @return AST node for term
-ASTNode *Parser::parse_term()
+/// @brief Parse a factor
+/// @param implicit_mul: False for an operand of try_implicit_mul, which chains the next factor itself
+/// @return AST node for factor
+ASTNode *Parser::parse_prefix(bool implicit_mul)
 {
-	auto left = parse_power();
+	// Signs are consecutive tokens, they are wrapped innermost first once the operand is parsed
+	size_t first = _cursor.position();
 
-	while (match(TokenType::STAR) || match(TokenType::SLASH))
-	{
-		Token op = consume();
-		auto right = parse_power();
-		char oper = (op.Type == TokenType::STAR) ? '*' : '/';
-
-		left = make_node<BinaryOpNode>(_arena, oper, left, right, op.line, op.column);
-	}
+	while (match(TokenType::MINUS) || match(TokenType::PLUS))
+		consume();
 
-	return left;
-}
+	size_t last = _cursor.position();
 
-/// @brief Parse a power / exponentiation
-/// @return AST node for power
-ASTNode *Parser::parse_power()
-{
-	auto base = parse_prefix();
+	// Every nested operand passes through here, bounding the recursion of groups, scripts and calls
+	if (_depth >= _max_depth)
+		return fail(DiagnosticCode::NESTING_TOO_DEEP, last, _max_depth);
 
-	if (match(TokenType::CARET) || match(TokenType::SUPERSCRIPT))
-	{
-		Token op = consume();
-		auto exponent = parse_power();
+	_depth++;
+	ASTNode *expr = parse_postfix(implicit_mul);
+	_depth--;
 
-		return make_node<BinaryOpNode>(_arena, '^', base, exponent, op.line, op.column);
-	}
+	if (failed())
+		return nullptr;
 
-	return base;
-}
+	const TokenStream &tokens = _cursor.stream();
 
-/// @brief Parse a factor
-/// @return AST node for factor
-ASTNode *Parser::parse_prefix()
-{
-	if (match(TokenType::MINUS) || match(TokenType::PLUS))
+	for (size_t i = last; i-- > first;)
 	{
-		Token op = consume();
-		auto expr = parse_prefix();
-		char oper = (op.Type == TokenType::MINUS) ? '-' : '+';
-
-		return make_node<UnaryOpNode>(_arena, oper, expr, op.line, op.column);
+		char oper = (tokens.types[i] == TokenType::MINUS) ? '-' : '+';
+		expr = build_node<UnaryOpNode>(oper, expr, tokens.offsets[i]);
 	}
 
-	return parse_postfix();
+	return expr;
 }
 
 /// @brief Parse a postfix expression
+/// @param implicit_mul: True to continue with try_implicit_mul
 /// @return AST node for postfix
-ASTNode *Parser::parse_postfix()
+ASTNode *Parser::parse_postfix(bool implicit_mul)
 {
 	auto expr = parse_primary();
 
-	while (!is_at_end())
-	{
-		auto it = POSTFIX_DISPATCH.find(current().Type);
-
-		if (it == POSTFIX_DISPATCH.end())
-			break;
+	if (failed())
+		return nullptr;
 
-		PostfixHandler handler = it->second;
+	while (PostfixHandler handler = POSTFIX_DISPATCH[static_cast<size_t>(current_type())])
+	{
 		expr = (this->*handler)(expr);
+
+		if (failed())
+			return nullptr;
 	}
 
-	return try_implicit_mul(expr);
+	return implicit_mul ? try_implicit_mul(expr) : expr;
 }
 
 /// @brief Parse a primary expression
 /// @return AST node for primary
 ASTNode *Parser::parse_primary()
 {
-	return PrimaryParser(*this, current()).parse();
+	return PrimaryParser::parse(*this);
 }
 
 // ======================
@@ -469,53 +808,68 @@ ASTNode *Parser::parse_primary()
 /// @return AST node for command
 ASTNode *Parser::parse_command()
 {
+	size_t cmd_index = _cursor.position();
 	Token cmd_token = consume();
-	const CommandInfo *info = cmd_token.Info;
+	const CommandInfo *info = LatexParser::get_command(cmd_token.Id);
 
 	if (!info)
-		return make_node<SymbolNode>(_arena, cmd_token.Value, cmd_token.line, cmd_token.column);
+		return build_node<SymbolNode>(cmd_token.Value, cmd_token.offset);
 
-	std::vector<ASTNode *> args;
-	args.reserve(info->mandatory_args + info->optional_args);
+	size_t start = _nodes.size();
 
 	for (int i = 0; i < info->optional_args; ++i)
 	{
+		ASTNode *arg = nullptr;
+
 		if (match(TokenType::BRACKET_OPEN))
 		{
 			consume();
 
-			args.push_back(parse_assignment());
-			expect(TokenType::BRACKET_CLOSE, "Expected ']' after optional argument");
-		}
-		else
-		{
-			args.push_back(nullptr);
+			arg = parse_expression();
+			expect(TokenType::BRACKET_CLOSE, DiagnosticCode::MISSING_OPTIONAL_CLOSE);
+
+			if (failed())
+				return nullptr;
 		}
+
+		_nodes.push_back(arg);
 	}
 
 	bool requires_braces = (info->mandatory_args > 1);
 
 	for (int i = 0; i < info->mandatory_args; ++i)
 	{
+		ASTNode *arg;
+
 		if (match(TokenType::BRACE_OPEN))
 		{
 			consume();
-			args.push_back(parse_assignment());
-			expect(TokenType::BRACE_CLOSE, "Expected '}' after mandatory argument");
+			arg = parse_expression();
+			expect(TokenType::BRACE_CLOSE, DiagnosticCode::MISSING_ARGUMENT_CLOSE);
 		}
 		else if (requires_braces)
 		{
-			throw ParseError(
-					"Command '" + std::string(cmd_token.Value) + "' requires braced arguments",
-					cmd_token.line, cmd_token.column);
+			return fail(DiagnosticCode::BRACES_REQUIRED, cmd_index);
+		}
+		else if (_depth >= _max_depth)
+		{
+			return fail(DiagnosticCode::NESTING_TOO_DEEP, _cursor.position(), _max_depth);
 		}
 		else
 		{
-			args.push_back(parse_primary());
+			// '\sqrt\sqrt...x' nests without passing through parse_prefix
+			_depth++;
+			arg = parse_primary();
+			_depth--;
 		}
+
+		if (failed())
+			return nullptr;
+
+		_nodes.push_back(arg);
 	}
 
-	return make_node<CommandNode>(_arena, cmd_token.Value, args, info, cmd_token.line, cmd_token.column);
+	return build_node<CommandNode>(cmd_token.Value, take_nodes(start), cmd_token.Id, cmd_token.offset);
 }
 
 /// @brief Parse subscripts and superscripts
@@ -532,7 +886,7 @@ ASTNode *Parser::parse_subsup(ASTNode *base)
 		consume();
 
 		if ((is_super && sup) || (!is_super && sub))
-			throw ParseError("Multiple scripts of the same type detected", current().line, current().column);
+			return fail(DiagnosticCode::DUPLICATE_SCRIPT, _cursor.position());
 
 		ASTNode *script;
 
@@ -540,7 +894,7 @@ ASTNode *Parser::parse_subsup(ASTNode *base)
 		{
 			consume();
 
-			script = parse_assignment();
+			script = parse_expression();
 			expect(TokenType::BRACE_CLOSE);
 		}
 		else
@@ -548,13 +902,16 @@ ASTNode *Parser::parse_subsup(ASTNode *base)
 			script = parse_prefix();
 		}
 
+		if (failed())
+			return nullptr;
+
 		if (is_super)
 			sup = script;
 		else
 			sub = script;
 	}
 
-	return make_node<ScriptNode>(_arena, base, sub, sup, base->line, base->column);
+	return build_node<ScriptNode>(base, sub, sup, base->offset);
 }
 
 /// @brief Parse a factorial operator
@@ -563,33 +920,46 @@ ASTNode *Parser::parse_subsup(ASTNode *base)
 ASTNode *Parser::parse_factorial(ASTNode *left)
 {
 	Token op = consume();
-	return make_node<UnaryOpNode>(_arena, '!', left, op.line, op.column);
+	return build_node<UnaryOpNode>('!', left, op.offset);
 }
 
 // ======================
 // -- MISC IMPL.
 // ======================
 
-/// @brief Try to parse implicit multiplication
+/// @brief Try to parse implicit multiplication, x y z builds x * (y * z)
 /// @param left: Left AST node
 /// @return AST node for implicit multiplication or left node if no implicit multiplication
 ASTNode *Parser::try_implicit_mul(ASTNode *left)
 {
+	// Factors are collected in a loop, so "x y z" nests no deeper than "x y", then folded from the right
+	size_t start = _nodes.size();
+	_nodes.push_back(left);
+
 	while (!is_at_end())
 	{
-		if (!MUL_LOOKUP.data[static_cast<size_t>(current().Type)])
+		if (!MUL_LOOKUP.data[static_cast<size_t>(current_type())])
 			break;
 
-		size_t last_pos = _position;
-		auto right = parse_prefix();
+		size_t last_pos = _cursor.position();
+		auto right = parse_prefix(false);
 
-		if (_position == last_pos)
+		if (failed())
+			return nullptr;
+
+		if (_cursor.position() == last_pos)
 			break;
 
-		left = make_node<BinaryOpNode>(_arena, '*', left, right, left->line, left->column);
+		_nodes.push_back(right);
 	}
 
-	return left;
+	ASTNode *product = _nodes.back();
+
+	for (size_t i = _nodes.size() - 1; i-- > start;)
+		product = build_node<BinaryOpNode>('*', _nodes[i], product, _nodes[i]->offset);
+
+	_nodes.resize(start);
+	return product;
 }
 
 /// @brief Try a function call
@@ -602,23 +972,35 @@ ASTNode *Parser::try_function_call(ASTNode *func)
 
 	Token open_paren = consume();
 
-	std::vector<ASTNode *> args;
+	size_t start = _nodes.size();
 
 	if (!match(TokenType::PAREN_CLOSE))
 	{
-		args.reserve(4);
-		args.push_back(parse_assignment());
+		ASTNode *arg = parse_expression();
+
+		if (failed())
+			return nullptr;
+
+		_nodes.push_back(arg);
 
 		while (match(TokenType::PUNCTUATION) && current().Value == ",")
 		{
 			consume();
-			args.push_back(parse_assignment());
+			arg = parse_expression();
+
+			if (failed())
+				return nullptr;
+
+			_nodes.push_back(arg);
 		}
 	}
 
-	expect(TokenType::PAREN_CLOSE, "Expected ')' after function arguments");
+	expect(TokenType::PAREN_CLOSE, DiagnosticCode::MISSING_CALL_CLOSE);
+
+	if (failed())
+		return nullptr;
 
-	return make_node<FunctionCallNode>(_arena, func, args, open_paren.line, open_paren.column);
+	return build_node<FunctionCallNode>(func, take_nodes(start), open_paren.offset);
 }
 
 /// @brief Try to parse arguments in curly braces
@@ -626,23 +1008,26 @@ ASTNode *Parser::try_function_call(ASTNode *func)
 /// @return AST node representing the applying of the braces to the base
 ASTNode *Parser::try_braced_call(ASTNode *base)
 {
-	bool is_escaped = (current().Type == TokenType::ESCAPED_BRACE_OPEN);
+	bool is_escaped = (current_type() == TokenType::ESCAPED_BRACE_OPEN);
 
 	Token opening = consume();
 
-	auto arg = parse_assignment();
+	auto arg = parse_expression();
+
+	if (failed())
+		return nullptr;
 
 	if (is_escaped)
 	{
-		expect(TokenType::ESCAPED_BRACE_CLOSE, "Expected '\\}' after escaped group");
+		expect(TokenType::ESCAPED_BRACE_CLOSE, DiagnosticCode::MISSING_ESCAPED_GROUP_CLOSE);
 	}
 	else
 	{
-		expect(TokenType::BRACE_CLOSE, "Expected '}' after group");
+		expect(TokenType::BRACE_CLOSE, DiagnosticCode::MISSING_GROUP_CLOSE);
 	}
 
-	std::vector<ASTNode *> args;
-	args.push_back(arg);
+	if (failed())
+		return nullptr;
 
-	return make_node<FunctionCallNode>(_arena, base, args, opening.line, opening.column);
+	return build_node<FunctionCallNode>(base, _arena.copy_span(&arg, 1), opening.offset);
 }
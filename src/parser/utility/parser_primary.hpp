@@ -1,7 +1,7 @@
 #ifndef PARSER_PRIMARY_HPP
 #define PARSER_PRIMARY_HPP
 
-#include <unordered_map>
+#include <array>
 
 #include "../../lexer/token_info.hpp"
 #include "../../ast/ast_node.hpp"
@@ -12,6 +12,7 @@ class Parser;
 // -- PRIMARY PARSER
 // ======================
 
+/// @brief Stateless primary dispatch, every handler works on the Parser it is given
 class PrimaryParser
 {
 	private:
@@ -19,71 +20,70 @@ class PrimaryParser
 		// -- DISPATCH DATA
 		// ======================
 
-		using PrimaryHandler = ASTNode *(PrimaryParser::*)();
+		using PrimaryHandler = ASTNode *(*)(Parser &);
 
-		static const std::unordered_map<TokenType, PrimaryHandler> PRIMARY_DISPATCH;
-		static const std::unordered_map<TokenType, TokenType> GROUP_CLOSERS;
-
-		// ======================
-		// -- PARSER REF
-		// ======================
-
-		Parser &_parser;
-		Token _tok;
+		static const std::array<PrimaryHandler, 256> PRIMARY_DISPATCH; // std::array: Handler per TokenType, nullptr if not a primary
+		static const std::array<TokenType, 256> GROUP_CLOSERS;          // std::array: Close token per group open token, END_OF_FILE otherwise
 
 		// ======================
 		// -- PRIMARY IMPL.
 		// ======================
 
 		/// @brief Parse a number literal
+		/// @param parser: The parser to read from
 		/// @return NumberNode
-		ASTNode *parse_number();
+		static ASTNode *parse_number(Parser &parser);
 
 		/// @brief Parse an identifier
+		/// @param parser: The parser to read from
 		/// @return VariableNode
-		ASTNode *parse_identifier();
+		static ASTNode *parse_identifier(Parser &parser);
 
 		/// @brief Parse an escaped brace group
+		/// @param parser: The parser to read from
 		/// @return GroupNode
-		ASTNode *parse_escaped_brace();
+		static ASTNode *parse_escaped_brace(Parser &parser);
 
 		/// @brief Parse a grouped expression with a close token from GROUP_CLOSERS
+		/// @param parser: The parser to read from
 		/// @return GroupNode
-		ASTNode *parse_group();
+		static ASTNode *parse_group(Parser &parser);
 
 		/// @brief Parse a symbol token (punctuation, spacing, symbol, alignment)
+		/// @param parser: The parser to read from
 		/// @return SymbolNode
-		ASTNode *parse_symbol();
+		static ASTNode *parse_symbol(Parser &parser);
 
 		/// @brief Delegate to Parser::parse_command
+		/// @param parser: The parser to read from
 		/// @return CommandNode
-		ASTNode *parse_command();
+		static ASTNode *parse_command(Parser &parser);
 
 		/// @brief Delegate to Parser::parse_environment
+		/// @param parser: The parser to read from
 		/// @return EnvironmentNode
-		ASTNode *parse_environment();
+		static ASTNode *parse_environment(Parser &parser);
 
 		/// @brief Delegate to Parser::parse_left_right
+		/// @param parser: The parser to read from
 		/// @return LeftRightNode
-		ASTNode *parse_left_right();
+		static ASTNode *parse_left_right(Parser &parser);
 
 	public:
 		// ======================
 		// -- CONSTRUCTORS
 		// ======================
 
-		/// @brief Construct a PrimaryParser bound to a Parser instance
-		/// @param parser: The owning parser
-		/// @param tok: The current token
-		explicit PrimaryParser(Parser &parser, Token tok) : _parser(parser), _tok(tok) {}
+		PrimaryParser() = delete;
 
 		// ======================
 		// -- PUBLIC METHODS
 		// ======================
 
-		/// @brief Parse a primary expression
+		/// @brief Parse a primary expression at the parser's current token
+		/// @param parser: The parser to read from
 		/// @return AST node for primary
-		ASTNode *parse();
+		static ASTNode *parse(Parser &parser);
 };
 
 #endif
@@ -10,47 +10,58 @@
 // -- INIT
 // ======================
 
-const std::unordered_map<TokenType, PrimaryParser::PrimaryHandler> PrimaryParser::PRIMARY_DISPATCH = {
-	{TokenType::NUMBER, &PrimaryParser::parse_number},
-	{TokenType::IDENTIFIER, &PrimaryParser::parse_identifier},
-	{TokenType::ESCAPED_BRACE_OPEN, &PrimaryParser::parse_escaped_brace},
-	{TokenType::BRACE_OPEN, &PrimaryParser::parse_group},
-	{TokenType::PAREN_OPEN, &PrimaryParser::parse_group},
-	{TokenType::BRACKET_OPEN, &PrimaryParser::parse_group},
-	{TokenType::DISPLAY_MATH_OPEN, &PrimaryParser::parse_group},
-	{TokenType::INLINE_MATH_OPEN, &PrimaryParser::parse_group},
-	{TokenType::PUNCTUATION, &PrimaryParser::parse_symbol},
-	{TokenType::SPACING, &PrimaryParser::parse_symbol},
-	{TokenType::SYMBOL, &PrimaryParser::parse_symbol},
-	{TokenType::ALIGNMENT, &PrimaryParser::parse_symbol},
-	{TokenType::COMMAND, &PrimaryParser::parse_command},
-	{TokenType::ENV_BEGIN, &PrimaryParser::parse_environment},
-	{TokenType::LEFT_WRAP, &PrimaryParser::parse_left_right}};
-
-const std::unordered_map<TokenType, TokenType> PrimaryParser::GROUP_CLOSERS = {
-	{TokenType::BRACE_OPEN, TokenType::BRACE_CLOSE},
-	{TokenType::PAREN_OPEN, TokenType::PAREN_CLOSE},
-	{TokenType::BRACKET_OPEN, TokenType::BRACKET_CLOSE},
-	{TokenType::DISPLAY_MATH_OPEN, TokenType::DISPLAY_MATH_CLOSE},
-	{TokenType::INLINE_MATH_OPEN, TokenType::INLINE_MATH_CLOSE}};
+const std::array<PrimaryParser::PrimaryHandler, 256> PrimaryParser::PRIMARY_DISPATCH = []() constexpr {
+	std::array<PrimaryHandler, 256> table{};
+
+	table[static_cast<size_t>(TokenType::NUMBER)] = &PrimaryParser::parse_number;
+	table[static_cast<size_t>(TokenType::IDENTIFIER)] = &PrimaryParser::parse_identifier;
+	table[static_cast<size_t>(TokenType::ESCAPED_BRACE_OPEN)] = &PrimaryParser::parse_escaped_brace;
+	table[static_cast<size_t>(TokenType::BRACE_OPEN)] = &PrimaryParser::parse_group;
+	table[static_cast<size_t>(TokenType::PAREN_OPEN)] = &PrimaryParser::parse_group;
+	table[static_cast<size_t>(TokenType::BRACKET_OPEN)] = &PrimaryParser::parse_group;
+	table[static_cast<size_t>(TokenType::DISPLAY_MATH_OPEN)] = &PrimaryParser::parse_group;
+	table[static_cast<size_t>(TokenType::INLINE_MATH_OPEN)] = &PrimaryParser::parse_group;
+	table[static_cast<size_t>(TokenType::PUNCTUATION)] = &PrimaryParser::parse_symbol;
+	table[static_cast<size_t>(TokenType::SPACING)] = &PrimaryParser::parse_symbol;
+	table[static_cast<size_t>(TokenType::SYMBOL)] = &PrimaryParser::parse_symbol;
+	table[static_cast<size_t>(TokenType::ALIGNMENT)] = &PrimaryParser::parse_symbol;
+	table[static_cast<size_t>(TokenType::COMMAND)] = &PrimaryParser::parse_command;
+	table[static_cast<size_t>(TokenType::ENV_BEGIN)] = &PrimaryParser::parse_environment;
+	table[static_cast<size_t>(TokenType::LEFT_WRAP)] = &PrimaryParser::parse_left_right;
+
+	return table;
+}();
+
+const std::array<TokenType, 256> PrimaryParser::GROUP_CLOSERS = []() constexpr {
+	std::array<TokenType, 256> table{};
+
+	for (auto &closer : table)
+		closer = TokenType::END_OF_FILE;
+
+	table[static_cast<size_t>(TokenType::BRACE_OPEN)] = TokenType::BRACE_CLOSE;
+	table[static_cast<size_t>(TokenType::PAREN_OPEN)] = TokenType::PAREN_CLOSE;
+	table[static_cast<size_t>(TokenType::BRACKET_OPEN)] = TokenType::BRACKET_CLOSE;
+	table[static_cast<size_t>(TokenType::DISPLAY_MATH_OPEN)] = TokenType::DISPLAY_MATH_CLOSE;
+	table[static_cast<size_t>(TokenType::INLINE_MATH_OPEN)] = TokenType::INLINE_MATH_CLOSE;
+
+	return table;
+}();
 
 // ======================
 // -- PRIMARY DISPATCH
 // ======================
 
 /// @brief Parse a primary expression
+/// @param parser: The parser to read from
 /// @return AST node for primary
-ASTNode *PrimaryParser::parse()
+ASTNode *PrimaryParser::parse(Parser &parser)
 {
-	auto it = PRIMARY_DISPATCH.find(_tok.Type);
+	PrimaryHandler handler = PRIMARY_DISPATCH[static_cast<size_t>(parser.current_type())];
 
-	if (it != PRIMARY_DISPATCH.end())
-		return (this->*it->second)();
+	if (handler)
+		return handler(parser);
 
-	throw ParseError(
-			"Unexpected token in primary: " + _parser.token_repr(_tok) + " @" +
-			std::to_string(_tok.line) + ':' + std::to_string(_tok.column),
-			_tok.line, _tok.column);
+	return parser.fail(DiagnosticCode::UNEXPECTED_PRIMARY, parser._cursor.position());
 }
 
 // ======================
@@ -58,77 +69,96 @@ ASTNode *PrimaryParser::parse()
 // ======================
 
 /// @brief Parse a number literal
+/// @param parser: The parser to read from
 /// @return NumberNode
-ASTNode *PrimaryParser::parse_number()
+ASTNode *PrimaryParser::parse_number(Parser &parser)
 {
-	Token tok = _parser.consume();
+	size_t index = parser._cursor.position();
+	Token tok = parser.consume();
 	double val = 0.0;
 
 	auto [ptr, ec] = std::from_chars(tok.Value.data(), tok.Value.data() + tok.Value.size(), val);
 
 	if (ec != std::errc{})
-	{
-		throw ParseError(
-				"Invalid number @" + std::to_string(tok.line) + ':' + std::to_string(tok.column),
-				tok.line, tok.column);
-	}
+		return parser.fail(DiagnosticCode::INVALID_NUMBER, index);
 
-	return make_node<NumberNode>(_parser._arena, val, tok.line, tok.column);
+	return parser.build_node<NumberNode>(val, tok.offset);
 }
 
 /// @brief Parse an identifier
+/// @param parser: The parser to read from
 /// @return VariableNode
-ASTNode *PrimaryParser::parse_identifier()
+ASTNode *PrimaryParser::parse_identifier(Parser &parser)
 {
-	Token tok = _parser.consume();
-	return make_node<VariableNode>(_parser._arena, tok.Value, tok.line, tok.column);
+	Token tok = parser.consume();
+	VariableNode *node = parser.build_node<VariableNode>(tok.Value, parser._symbols.intern(tok.Value), tok.offset);
+
+	// A worker's ids are local to its table, try_parse_parallel maps them once the slices are joined
+	if (parser._collect_symbols)
+		parser._symbol_nodes.push_back(node);
+
+	return node;
 }
 
 /// @brief Parse an escaped brace group
+/// @param parser: The parser to read from
 /// @return GroupNode
-ASTNode *PrimaryParser::parse_escaped_brace()
+ASTNode *PrimaryParser::parse_escaped_brace(Parser &parser)
 {
-	Token tok = _parser.consume();
-	auto expr = _parser.parse_expression();
-	_parser.expect(TokenType::ESCAPED_BRACE_CLOSE);
-	return make_node<GroupNode>(_parser._arena, expr, tok.line, tok.column);
+	Token tok = parser.consume();
+	auto expr = parser.parse_expression(BindingPower::ADDITIVE);
+	parser.expect(TokenType::ESCAPED_BRACE_CLOSE);
+
+	if (parser.failed())
+		return nullptr;
+
+	return parser.build_node<GroupNode>(parser._arena.copy_span(&expr, 1), tok.offset);
 }
 
 /// @brief Parse a grouped expression with a close token from GROUP_CLOSERS
+/// @param parser: The parser to read from
 /// @return GroupNode
-ASTNode *PrimaryParser::parse_group()
+ASTNode *PrimaryParser::parse_group(Parser &parser)
 {
-	Token tok = _parser.consume();
-	auto expr = _parser.parse_assignment();
-	_parser.expect(GROUP_CLOSERS.at(tok.Type));
-	return make_node<GroupNode>(_parser._arena, expr, tok.line, tok.column);
+	Token tok = parser.consume();
+	auto expr = parser.parse_expression();
+	parser.expect(GROUP_CLOSERS[static_cast<size_t>(tok.Type)]);
+
+	if (parser.failed())
+		return nullptr;
+
+	return parser.build_node<GroupNode>(parser._arena.copy_span(&expr, 1), tok.offset);
 }
 
 /// @brief Parse a symbol token (punctuation, spacing, symbol, alignment)
+/// @param parser: The parser to read from
 /// @return SymbolNode
-ASTNode *PrimaryParser::parse_symbol()
+ASTNode *PrimaryParser::parse_symbol(Parser &parser)
 {
-	Token tok = _parser.consume();
-	return make_node<SymbolNode>(_parser._arena, tok.Value, tok.line, tok.column);
+	Token tok = parser.consume();
+	return parser.build_node<SymbolNode>(tok.Value, tok.offset);
 }
 
 /// @brief Delegate to Parser::parse_command
+/// @param parser: The parser to read from
 /// @return AST node for command
-ASTNode *PrimaryParser::parse_command()
+ASTNode *PrimaryParser::parse_command(Parser &parser)
 {
-	return _parser.parse_command();
+	return parser.parse_command();
 }
 
 /// @brief Delegate to Parser::parse_environment
+/// @param parser: The parser to read from
 /// @return AST node for environment
-ASTNode *PrimaryParser::parse_environment()
+ASTNode *PrimaryParser::parse_environment(Parser &parser)
 {
-	return _parser.parse_environment();
+	return parser.parse_environment();
 }
 
 /// @brief Delegate to Parser::parse_left_right
+/// @param parser: The parser to read from
 /// @return AST node for left-right
-ASTNode *PrimaryParser::parse_left_right()
+ASTNode *PrimaryParser::parse_left_right(Parser &parser)
 {
-	return _parser.parse_left_right();
+	return parser.parse_left_right();
 }
@@ -2,40 +2,33 @@
 #define SEMANTIC_ANALYZER_HPP
 
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
+#include <array>
+#include <cstdint>
 #include <string_view>
 #include <utility>
 #include <vector>
-#include <functional>
 
 #include "../ast/ast_node.hpp"
-#include "../ast/ast_visitor.hpp"
+#include "../ast/utility/ast_walker.hpp"
+#include "../ast/utility/constant_folder.hpp"
+#include "../ast/utility/symbol_table.hpp"
+#include "../diagnostics/diagnostic.hpp"
+#include "./semantic_rules.hpp"
 
 // ======================
 // -- SemanticError
 // ======================
 
-/// @brief Construct a semantic error
-/// @param msg: Error message
-/// @param l: Line number where error occurred
-/// @param c: Column number where error occurred
-struct SemanticError
-{
-	public:
-		std::string message;
-		int line;
-		int column;
-
-		SemanticError(const std::string &msg, int l, int c)
-			: message(msg), line(l), column(c) {}
-};
+/// @brief A semantic error, see diagnostic_text for its message
+using SemanticError = Diagnostic;
 
 // ======================
 // -- SemanticAnalyzer
 // ======================
 
-class SemanticAnalyzer : public ASTVisitor
+/// @brief Checks an AST for semantic errors with the rules of a RuleSet
+/// @note Nodes are visited post-order by an ASTWalker, each node only runs the enabled rules subscribed to its type
+class SemanticAnalyzer
 {
 	private:
 		// ======================
@@ -43,95 +36,144 @@ class SemanticAnalyzer : public ASTVisitor
 		// ======================
 
 		std::vector<SemanticError> errors;
-		std::unordered_set<std::string_view> defined_variables;
-		std::unordered_map<std::string_view, std::pair<bool, std::pair<int, int>>> variable_usage;
+		ASTWalker walker; // ASTWalker: Explicit traversal stack, kept between analyses
+		size_t nodes_checked = 0; // size_t: Nodes passed to check_node since begin_nodes
+
+		/// @brief A variable occurrence, in visit order
+		struct SymbolEvent
+		{
+			SymbolId symbol;  // SymbolId: The variable
+			uint32_t offset;  // uint32_t: Source byte offset of the VariableNode
+			bool definition;  // bool: Target of an assignment, its VariableNode is also an occurrence
+		};
+
+		/// @brief What one analysis saw of a variable
+		struct SymbolState
+		{
+			uint32_t generation = 0;       // uint32_t: Analysis the state belongs to, older states are stale
+			uint32_t occurrences = 0;      // uint32_t: # of VariableNodes, assignment targets included
+			uint32_t definitions = 0;      // uint32_t: # of assignments to the variable
+			uint32_t first_seen = 0;       // uint32_t: Smallest offset of any occurrence
+			uint32_t first_definition = 0; // uint32_t: Smallest offset of an assignment target
+		};
+
+		std::vector<SymbolEvent> symbol_events;   // std::vector: Occurrences of the current analysis, only with SemanticRule::VARIABLES
+		std::vector<SymbolState> symbol_states;   // std::vector: Indexed by SymbolId, kept between analyses
+		std::vector<SymbolId> symbols_seen;       // std::vector: Ids with a current state, in first-seen order
+		uint32_t generation = 0;                  // uint32_t: Current analysis, see SymbolState::generation
+
+		// ======================
+		// -- RULE DATA
+		// ======================
+
+		RuleSet enabled_rules = RuleSets::DEFAULT;                                         // RuleSet: Rules the masks were built from
+		std::array<RuleSet, AST_NODE_TYPE_COUNT> node_masks{};                             // std::array: Enabled rules per ASTNodeType
+		std::array<RuleSet, static_cast<size_t>(CommandRule::COUNT)> command_masks{};      // std::array: Enabled rules per CommandInfo::rule, CommandNodes only
+		std::array<RuleStats, static_cast<size_t>(SemanticRule::COUNT)> stats{};           // std::array: Counters per rule, kept until reset_rule_stats
+		bool profiling = false;                                                            // bool: Time every rule call into stats
 
 		// ======================
 		// -- DISPATCH DATA
 		// ======================
 
-		using ValidatorFunc = std::function<void(SemanticAnalyzer *, CommandNode &)>;
-		static const std::unordered_map<std::string_view, ValidatorFunc> VALIDATOR_DISPATCH_TABLE;
+		/// @brief A rule and the nodes it subscribes to
+		struct RuleInfo
+		{
+			const char *name;    // const char*: Name for reports
+			uint32_t node_types; // uint32_t: node_type_bit of every ASTNodeType the rule runs on
+			CommandRule command; // CommandRule: CommandNodes whose CommandInfo::rule matches, NONE for none
+		};
+
+		static const std::array<RuleInfo, static_cast<size_t>(SemanticRule::COUNT)> RULES;        // std::array: Indexed by SemanticRule
+		static const std::array<CommandRule, static_cast<size_t>(CommandId::COUNT)> COMMAND_RULES; // std::array: CommandInfo::rule of each command, resolved once
 
 		// ======================
 		// -- PRIVATE METHODS
 		// ======================
 
-		/// @brief Visit a number node
-		/// @param node: The current node
-		void visit(NumberNode &node) override;
+		/// @brief Rebuild node_masks and command_masks for a RuleSet
+		/// @param rules: Rules to enable
+		void build_rule_masks(RuleSet rules);
 
-		/// @brief Visit a variable node
-		/// @param node: The current node
-		void visit(VariableNode &node) override;
+		/// @brief Run every rule of a mask on a node, in SemanticRule order
+		/// @param mask: Enabled rules subscribed to the node, not 0
+		/// @param node: The node
+		void run_rules(RuleSet mask, ASTNode &node);
 
-		/// @brief Visit a symbol node
-		/// @param node: The current node
-		void visit(SymbolNode &node) override;
+		/// @brief Run one rule on a node
+		/// @param rule: The rule
+		/// @param node: A node the rule subscribes to
+		void run_rule(SemanticRule rule, ASTNode &node);
 
-		/// @brief Visit a assignment node
-		/// @param node: The current node
-		void visit(AssignNode &node) override;
+		// ======================
+		// -- RULES
+		// ======================
 
-		/// @brief Visit a group node
-		/// @param node: The current node
-		void visit(GroupNode &node) override;
+		/// @brief RULE: SemanticRule::NUMBER_VALUE
+		/// @param node: NumberNode
+		void check_number_value(ASTNode &node);
 
-		/// @brief Visit a binary node
-		/// @param node: The current node
-		void visit(BinaryOpNode &node) override;
+		/// @brief RULE: SemanticRule::ASSIGN_TARGET
+		/// @param node: AssignNode
+		void check_assign_target(ASTNode &node);
 
-		/// @brief Visit a unary node
-		/// @param node: The current node
-		void visit(UnaryOpNode &node) override;
+		/// @brief RULE: SemanticRule::DIVISION
+		/// @param node: BinaryOpNode or a CommandNode with CommandRule::DIVISOR
+		void check_division(ASTNode &node);
 
-		/// @brief Visit a command node
-		/// @param node: The current node
-		void visit(CommandNode &node) override;
+		/// @brief RULE: SemanticRule::RADICAND
+		/// @param node: CommandNode with CommandRule::RADICAND
+		void validate_root(ASTNode &node);
 
-		/// @brief Visit a script node
-		/// @param node: The current node
-		void visit(ScriptNode &node) override;
+		/// @brief RULE: SemanticRule::LOGARITHM
+		/// @param node: CommandNode with CommandRule::LOGARITHM or a FunctionCallNode
+		void validate_logarithm(ASTNode &node);
 
-		/// @brief Visit a function call node
-		/// @param node: The current node
-		void visit(FunctionCallNode &node) override;
+		/// @brief RULE: SemanticRule::INVERSE_TRIG
+		/// @param node: CommandNode with CommandRule::INVERSE_TRIG
+		void validate_inverse_trig(ASTNode &node);
 
-		/// @brief Visit a sequence node
-		/// @param node: The current node
-		void visit(SequenceNode &node) override;
+		/// @brief RULE: SemanticRule::RECIPROCAL_TRIG
+		/// @param node: CommandNode with CommandRule::RECIPROCAL_TRIG
+		void validate_reciprocal_trig(ASTNode &node);
 
-		/// @brief Visit a environment node
-		/// @param node: The current node
-		void visit(EnvironmentNode &node) override;
+		/// @brief RULE: SemanticRule::BINOMIAL
+		/// @param node: CommandNode with CommandRule::BINOMIAL
+		void validate_binom(ASTNode &node);
 
-		/// @brief Visit a left-right node
-		/// @param node: The current node
-		void visit(LeftRightNode &node) override;
+		/// @brief RULE: SemanticRule::VARIABLES, reported by check_variables once every node is checked
+		/// @param node: VariableNode or AssignNode
+		void record_variable(ASTNode &node);
 
 		// ======================
 		// -- PRIVATE UTILITY
 		// ======================
 
+		/// @brief Folded value of an operand, see ConstantFolder
+		/// @param operand: Operand to read, may be nullptr
+		/// @param value: Set to the value if operand is constant
+		/// @return True if operand is constant
+		static bool constant_operand(const ASTNode *operand, double &value)
+		{
+			return operand && operand->constant_value(value);
+		}
+
 		/// @brief Check division by 0
 		/// @param denominator: Denominator
 		void check_division_by_zero(const ASTNode *denominator);
 
-		/// @brief Validate frac
-		/// @param node: The current node
-		void validate_frac(CommandNode &node);
-
 		/// @brief Validate sqrt
 		/// @param operand: Operand to check
-		/// @param line: Line number
-		/// @param column: Column number
-		void validate_sqrt(const ASTNode *operand, int line, int column);
+		/// @param offset: Source byte offset
+		void validate_sqrt(const ASTNode *operand, uint32_t offset);
 
 		/// @brief Validate log
 		/// @param operand: Operand to check
-		/// @param line: Line number
-		/// @param column: Column number
-		void validate_log(const ASTNode *operand, int line, int column);
+		/// @param offset: Source byte offset
+		void validate_log(const ASTNode *operand, uint32_t offset);
+
+		/// @brief Report USE_BEFORE_DEFINITION and UNUSED_VARIABLE from the symbol events of the analysis
+		void check_variables();
 
 	public:
 		// ======================
@@ -139,7 +181,8 @@ class SemanticAnalyzer : public ASTVisitor
 		// ======================
 
 		/// @brief Semantic Analyzer Constructor
-		SemanticAnalyzer() = default;
+		/// @param rules: Rules to run, see set_rules
+		explicit SemanticAnalyzer(RuleSet rules = RuleSets::DEFAULT) { build_rule_masks(rules); }
 
 		// ======================
 		// -- PUBLIC METHODS
@@ -149,12 +192,106 @@ class SemanticAnalyzer : public ASTVisitor
 		/// @param root: AST Root
 		void analyze(ASTNode *&root);
 
+		/// @brief Drop the errors and variables of the last analysis, keeping their storage
+		void clear();
+
+		/// @brief Choose the rules later analyses run, e.g. RuleSets::SYNTAX or RuleSets::ALL
+		/// @param rules: Bit per SemanticRule, see rule_bit
+		/// @note SemanticRule::VARIABLES needs the SymbolIds a Parser interns, every AST analyzed must come from
+		/// parsers sharing one SymbolTable
+		void set_rules(RuleSet rules)
+		{
+			if (rules != enabled_rules)
+				build_rule_masks(rules);
+		}
+
+		/// @brief Rules analyses run
+		/// @return RuleSet
+		RuleSet rules() const { return enabled_rules; }
+
+		/// @brief Time every rule call, off by default as it reads the clock twice per call
+		/// @param enabled: True to fill RuleStats::nanoseconds
+		void set_profiling(bool enabled) { profiling = enabled; }
+
+		/// @brief Counters of a rule since construction or reset_rule_stats
+		/// @param rule: The rule
+		/// @return const RuleStats&
+		const RuleStats &rule_stats(SemanticRule rule) const { return stats[static_cast<size_t>(rule)]; }
+
+		/// @brief Zero the counters of every rule
+		void reset_rule_stats() { stats = {}; }
+
+		/// @brief Name of a rule, e.g. "division"
+		/// @param rule: The rule
+		/// @return const char*
+		static const char *rule_name(SemanticRule rule) { return RULES[static_cast<size_t>(rule)].name; }
+
+		/// @brief Start an analysis fed one node at a time, e.g. by Parser::try_validate
+		void begin_nodes();
+
+		/// @brief Fold and check one node, every node below it must have been checked already
+		/// @param node: The node
+		/// @note Every node is folded whatever the rules, an analyzed AST carries its ASTNode::constant_value
+		void check_node(ASTNode &node)
+		{
+			nodes_checked++;
+			ConstantFolder::fold(node);
+
+			RuleSet mask = node_masks[static_cast<size_t>(node.Type)];
+
+			if (node.Type == ASTNodeType::COMMAND)
+			{
+				CommandId id = static_cast<CommandNode &>(node).id;
+
+				if (id < CommandId::COUNT)
+					mask |= command_masks[static_cast<size_t>(COMMAND_RULES[static_cast<size_t>(id)])];
+			}
+
+			// Most nodes, e.g. every VariableNode without SemanticRule::VARIABLES, have no rule to run
+			if (mask)
+				run_rules(mask, node);
+		}
+
+		/// @brief Finish an analysis fed one node at a time, reports EMPTY_AST if no node was checked
+		void end_nodes();
+
+		/// @brief Position to return to with drop_errors
+		/// @return # of errors in the high 32 bits, # of symbol events in the low 32 bits
+		size_t error_mark() const { return (static_cast<uint64_t>(errors.size()) << 32) | symbol_events.size(); }
+
+		/// @brief Forget what nodes checked since a mark reported, e.g. nodes the parser left out of the tree
+		/// @param mark: Value of error_mark
+		void drop_errors(size_t mark)
+		{
+			errors.resize(static_cast<uint64_t>(mark) >> 32);
+			symbol_events.resize(mark & 0xFFFFFFFFu);
+		}
+
+		/// @brief Parser::NodeHooks::built, checks each node as it is built
+		/// @param analyzer: The SemanticAnalyzer
+		/// @param node: The node
+		static void built_hook(void *analyzer, ASTNode &node) { static_cast<SemanticAnalyzer *>(analyzer)->check_node(node); }
+
+		/// @brief Parser::NodeHooks::mark
+		/// @param analyzer: The SemanticAnalyzer
+		/// @return size_t
+		static size_t mark_hook(void *analyzer) { return static_cast<SemanticAnalyzer *>(analyzer)->error_mark(); }
+
+		/// @brief Parser::NodeHooks::drop
+		/// @param analyzer: The SemanticAnalyzer
+		/// @param mark: Value of mark_hook
+		static void drop_hook(void *analyzer, size_t mark) { static_cast<SemanticAnalyzer *>(analyzer)->drop_errors(mark); }
+
 		/// @brief Check to see if the AST has any errors
 		bool has_errors() const { return !errors.empty(); }
 
 		/// @brief Get all errors
 		/// @return const std::vector<SemanticError>&
 		const std::vector<SemanticError> &get_errors() const { return errors; }
+
+		/// @brief Count errors by code
+		/// @return DiagnosticCounts indexed by DiagnosticCode
+		DiagnosticCounts error_counts() const { return count_diagnostics(errors); }
 };
 
 #endif
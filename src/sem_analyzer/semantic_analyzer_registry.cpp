@@ -1,4 +1,5 @@
-#include <cmath>
+#include <algorithm>
+#include <chrono>
 
 #include "./semantic_analyzer.hpp"
 
@@ -10,212 +11,117 @@
 /// @param root: AST Root
 void SemanticAnalyzer::analyze(ASTNode *&root)
 {
-	errors.clear();
-	defined_variables.clear();
-	variable_usage.clear();
+	clear();
 
 	if (!root)
 	{
-		errors.push_back({"Empty AST", 0, 0});
+		errors.push_back({DiagnosticCode::EMPTY_AST, 0});
 		return;
 	}
 
-	root->accept(*this);
+	walker.post_order(root, [this](ASTNode &node) { check_node(node); });
+	check_variables();
 }
 
-/// @brief Visit a number node
-/// @param node: The current node
-void SemanticAnalyzer::visit(NumberNode &node)
+/// @brief Drop the errors and variables of the last analysis, keeping their storage
+void SemanticAnalyzer::clear()
 {
-	if (std::isnan(node.value) || std::isinf(node.value))
-	{
-		errors.push_back({"Invalid number value",
-				node.line,
-				node.column});
-	}
-}
-
-/// @brief Visit a variable node
-/// @param node: The current node
-void SemanticAnalyzer::visit(VariableNode &node)
-{
-	variable_usage[node.name] = {true, {node.line, node.column}};
+	errors.clear();
+	symbol_events.clear();
 }
 
-/// @brief Visit a symbol node
-/// @param node: The current node
-void SemanticAnalyzer::visit(SymbolNode &node)
+/// @brief Start an analysis fed one node at a time, e.g. by Parser::try_validate
+void SemanticAnalyzer::begin_nodes()
 {
-	// no impl, symbol always valid
+	clear();
+	nodes_checked = 0;
 }
 
-/// @brief Visit a assignment node
-/// @param node: The current node
-void SemanticAnalyzer::visit(AssignNode &node)
+/// @brief Finish an analysis fed one node at a time, reports EMPTY_AST if no node was checked
+void SemanticAnalyzer::end_nodes()
 {
-	if (node.target)
-		node.target->accept(*this);
-
-	if (node.value)
-		node.value->accept(*this);
-
-	if (node.target && node.target->Type == ASTNodeType::VARIABLE)
+	// Every statement builds at least one node, none means analyze() would have seen a null root
+	if (nodes_checked == 0)
 	{
-		const auto *var = static_cast<const VariableNode *>(node.target);
-		defined_variables.insert(var->name);
+		errors.push_back({DiagnosticCode::EMPTY_AST, 0});
+		return;
 	}
 
-	if (node.target && node.target->Type == ASTNodeType::NUMBER)
-	{
-		errors.push_back({"Cannot assign to a literal value",
-				node.line,
-				node.column});
-	}
+	check_variables();
 }
 
-/// @brief Visit a group node
-/// @param node: The current node
-void SemanticAnalyzer::visit(GroupNode &node)
+/// @brief Report USE_BEFORE_DEFINITION and UNUSED_VARIABLE from the symbol events of the analysis
+void SemanticAnalyzer::check_variables()
 {
-	for (const auto &element : node.elements)
-	{
-		if (!element)
-			continue;
-
-		element->accept(*this);
-	}
-}
-
-/// @brief Visit a binary node
-/// @param node: The current node
-void SemanticAnalyzer::visit(BinaryOpNode &node)
-{
-	if (node.left)
-		node.left->accept(*this);
-	if (node.right)
-		node.right->accept(*this);
+	if (symbol_events.empty())
+		return;
 
-	if (node.op == '/')
+	// A new generation makes every state stale without touching them
+	if (++generation == 0)
 	{
-		check_division_by_zero(node.right);
-	}
-}
+		for (auto &state : symbol_states)
+			state.generation = 0;
 
-/// @brief Visit a unary node
-/// @param node: The current node
-void SemanticAnalyzer::visit(UnaryOpNode &node)
-{
-	if (node.operand)
-	{
-		node.operand->accept(*this);
+		generation = 1;
 	}
-}
 
-/// @brief Visit a command node
-/// @param node: The current node
-void SemanticAnalyzer::visit(CommandNode &node)
-{
-	for (auto &arg : node.arguments)
-	{
-		if (arg)
-			arg->accept(*this);
-	}
-
-	auto it = VALIDATOR_DISPATCH_TABLE.find(node.name);
+	symbols_seen.clear();
 
-	if (it != VALIDATOR_DISPATCH_TABLE.end())
+	for (const SymbolEvent &event : symbol_events)
 	{
-		it->second(this, node);
-	}
-}
+		if (event.symbol >= symbol_states.size())
+			symbol_states.resize(static_cast<size_t>(event.symbol) + 1);
 
-/// @brief Visit a script node
-/// @param node: The current node
-void SemanticAnalyzer::visit(ScriptNode &node)
-{
-	node.base->accept(*this);
+		SymbolState &state = symbol_states[event.symbol];
 
-	if (node.subscript)
-	{
-		node.subscript->accept(*this);
-	}
+		if (state.generation != generation)
+		{
+			state = {generation, 0, 0, UINT32_MAX, UINT32_MAX};
+			symbols_seen.push_back(event.symbol);
+		}
 
-	if (node.superscript)
-	{
-		node.superscript->accept(*this);
+		if (event.definition)
+		{
+			state.definitions++;
+			state.first_definition = std::min(state.first_definition, event.offset);
+		}
+		else
+		{
+			state.occurrences++;
+			state.first_seen = std::min(state.first_seen, event.offset);
+		}
 	}
-}
 
-/// @brief Visit a function call node
-/// @param node: The current node
-void SemanticAnalyzer::visit(FunctionCallNode &node)
-{
-	node.function->accept(*this);
+	RuleStats &counters = stats[static_cast<size_t>(SemanticRule::VARIABLES)];
+	size_t reported = errors.size();
+	auto start = profiling ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
 
-	for (auto &arg : node.args)
+	for (SymbolId id : symbols_seen)
 	{
-		if (!arg)
-			continue;
+		const SymbolState &state = symbol_states[id];
 
-		arg->accept(*this);
-	}
-}
-
-/// @brief Visit a sequence node
-/// @param node: The current node
-void SemanticAnalyzer::visit(SequenceNode &node)
-{
-	for (auto &element : node.elements)
-	{
-		if (!element)
+		// Never assigned, e.g. the x of x^2, a free variable
+		if (state.definitions == 0)
 			continue;
 
-		element->accept(*this);
-	}
-}
-
-/// @brief Visit a environment node
-/// @param node: The current node
-void SemanticAnalyzer::visit(EnvironmentNode &node)
-{
-	for (auto &vector : node.content)
-	{
-		for (auto &element : vector)
+		// Every target is also an occurrence, so only a read can come before the first target
+		if (state.first_seen < state.first_definition)
 		{
-			if (!element)
-				continue;
-
-			element->accept(*this);
+			errors.push_back({DiagnosticCode::USE_BEFORE_DEFINITION,
+					state.first_seen,
+					{state.first_seen, id}});
 		}
-	}
-}
 
-/// @brief Visit a left-right node
-/// @param node: The current node
-void SemanticAnalyzer::visit(LeftRightNode &node)
-{
-	if (!node.content)
-		return;
-
-	node.content->accept(*this);
-}
-
-/// @brief Check division by 0
-/// @param denominator: Denominator
-void SemanticAnalyzer::check_division_by_zero(const ASTNode *denominator)
-{
-	if (!denominator)
-		return;
-
-	if (denominator->Type == ASTNodeType::NUMBER)
-	{
-		const auto *num = static_cast<const NumberNode *>(denominator);
-
-		if (num->value == 0.0)
+		if (state.occurrences == state.definitions)
 		{
-			errors.push_back({"Division by zero",
-					denominator->line,
-					denominator->column});
+			errors.push_back({DiagnosticCode::UNUSED_VARIABLE,
+					state.first_definition,
+					{state.first_definition, id}});
 		}
 	}
+
+	counters.reports += errors.size() - reported;
+
+	if (profiling)
+		counters.nanoseconds += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
 }
@@ -1,113 +1,380 @@
+#include <chrono>
+#include <cmath>
+
 #include "./semantic_analyzer.hpp"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 // ======================
 // -- INIT
 // ======================
 
-const std::unordered_map<std::string_view, SemanticAnalyzer::ValidatorFunc> SemanticAnalyzer::VALIDATOR_DISPATCH_TABLE = {
-	{"\\frac", [](SemanticAnalyzer *s, CommandNode &n)
-		{
-			if (n.arguments.size() >= 2)
-				s->check_division_by_zero(n.arguments[1]);
-		}},
-	{"\\sqrt", [](SemanticAnalyzer *s, CommandNode &n)
+const std::array<SemanticAnalyzer::RuleInfo, static_cast<size_t>(SemanticRule::COUNT)> SemanticAnalyzer::RULES = {{
+	{"number_value", node_type_bit(ASTNodeType::NUMBER), CommandRule::NONE},
+	{"assign_target", node_type_bit(ASTNodeType::ASSIGN), CommandRule::NONE},
+	{"division", node_type_bit(ASTNodeType::BINARY_OP), CommandRule::DIVISOR},
+	{"radicand", 0, CommandRule::RADICAND},
+	{"logarithm", node_type_bit(ASTNodeType::FUNCTION_CALL), CommandRule::LOGARITHM},
+	{"inverse_trig", 0, CommandRule::INVERSE_TRIG},
+	{"reciprocal_trig", 0, CommandRule::RECIPROCAL_TRIG},
+	{"binomial", 0, CommandRule::BINOMIAL},
+	{"variables", node_type_bit(ASTNodeType::VARIABLE) | node_type_bit(ASTNodeType::ASSIGN), CommandRule::NONE},
+}};
+
+const std::array<CommandRule, static_cast<size_t>(CommandId::COUNT)> SemanticAnalyzer::COMMAND_RULES = []
+{
+	std::array<CommandRule, static_cast<size_t>(CommandId::COUNT)> table{};
+
+	// CommandInfo::rule is declared in the registry, the lexer already resolved each name to its CommandId
+	for (size_t id = 0; id < table.size(); id++)
+		table[id] = LatexParser::get_command(static_cast<CommandId>(id))->rule;
+
+	return table;
+}();
+
+// ======================
+// -- RULE MASKS
+// ======================
+
+namespace
+{
+	/// @brief Index of the lowest set bit of a mask
+	/// @param mask: The mask, not 0
+	/// @return uint32_t
+	inline uint32_t lowest_bit(RuleSet mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return static_cast<uint32_t>(index);
+#else
+		return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+	}
+}
+
+/// @brief Rebuild node_masks and command_masks for a RuleSet
+/// @param rules: Rules to enable
+void SemanticAnalyzer::build_rule_masks(RuleSet rules)
+{
+	enabled_rules = rules;
+	node_masks = {};
+	command_masks = {};
+
+	for (size_t i = 0; i < RULES.size(); i++)
+	{
+		RuleSet bit = rule_bit(static_cast<SemanticRule>(i));
+
+		if (!(rules & bit))
+			continue;
+
+		for (size_t type = 0; type < AST_NODE_TYPE_COUNT; type++)
 		{
-			size_t radicand_idx = n.arguments.size() == 2 ? 1 : 0;
-
-			if (radicand_idx < n.arguments.size() && n.arguments[radicand_idx])
-			{
-				s->validate_sqrt(n.arguments[radicand_idx], n.line, n.column);
-			}
-		}},
-	{"\\log", [](SemanticAnalyzer *s, CommandNode &n)
+			if (RULES[i].node_types & node_type_bit(static_cast<ASTNodeType>(type)))
+				node_masks[type] |= bit;
+		}
+
+		if (RULES[i].command != CommandRule::NONE)
+			command_masks[static_cast<size_t>(RULES[i].command)] |= bit;
+	}
+}
+
+/// @brief Run every rule of a mask on a node, in SemanticRule order
+/// @param mask: Enabled rules subscribed to the node, not 0
+/// @param node: The node
+void SemanticAnalyzer::run_rules(RuleSet mask, ASTNode &node)
+{
+	do
+	{
+		auto rule = static_cast<SemanticRule>(lowest_bit(mask));
+		RuleStats &counters = stats[static_cast<size_t>(rule)];
+		size_t reported = errors.size();
+
+		if (profiling) [[unlikely]]
 		{
-			if (!n.arguments.empty())
-				s->validate_log(n.arguments[0], n.line, n.column);
-		}},
-	{"\\ln", [](SemanticAnalyzer *s, CommandNode &n)
+			auto start = std::chrono::steady_clock::now();
+			run_rule(rule, node);
+			counters.nanoseconds += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		}
+		else
 		{
-			if (!n.arguments.empty())
-				s->validate_log(n.arguments[0], n.line, n.column);
-		}}};
+			run_rule(rule, node);
+		}
+
+		counters.runs++;
+		counters.reports += errors.size() - reported;
+		mask &= mask - 1;
+	} while (mask);
+}
+
+/// @brief Run one rule on a node
+/// @param rule: The rule
+/// @param node: A node the rule subscribes to
+void SemanticAnalyzer::run_rule(SemanticRule rule, ASTNode &node)
+{
+	// A switch rather than a table of member pointers, so each rule inlines here
+	switch (rule)
+	{
+		case SemanticRule::NUMBER_VALUE:
+			check_number_value(node);
+			break;
+		case SemanticRule::ASSIGN_TARGET:
+			check_assign_target(node);
+			break;
+		case SemanticRule::DIVISION:
+			check_division(node);
+			break;
+		case SemanticRule::RADICAND:
+			validate_root(node);
+			break;
+		case SemanticRule::LOGARITHM:
+			validate_logarithm(node);
+			break;
+		case SemanticRule::INVERSE_TRIG:
+			validate_inverse_trig(node);
+			break;
+		case SemanticRule::RECIPROCAL_TRIG:
+			validate_reciprocal_trig(node);
+			break;
+		case SemanticRule::BINOMIAL:
+			validate_binom(node);
+			break;
+		case SemanticRule::VARIABLES:
+			record_variable(node);
+			break;
+		case SemanticRule::COUNT:
+			break;
+	}
+}
 
 // ======================
 // -- FUNCTION IMPL.
 // ======================
 
-/// @brief Validate frac
-/// @param node: The current node
-void SemanticAnalyzer::validate_frac(CommandNode &node)
+/// @brief RULE: SemanticRule::NUMBER_VALUE
+/// @param node: NumberNode
+void SemanticAnalyzer::check_number_value(ASTNode &node)
+{
+	const auto &number = static_cast<const NumberNode &>(node);
+
+	if (std::isnan(number.value) || std::isinf(number.value))
+	{
+		errors.push_back({DiagnosticCode::INVALID_NUMBER_VALUE,
+				node.offset,
+				{node.offset, 0}});
+	}
+}
+
+/// @brief RULE: SemanticRule::ASSIGN_TARGET
+/// @param node: AssignNode
+void SemanticAnalyzer::check_assign_target(ASTNode &node)
+{
+	const auto &assign = static_cast<const AssignNode &>(node);
+
+	if (assign.target && assign.target->Type == ASTNodeType::NUMBER)
+	{
+		errors.push_back({DiagnosticCode::ASSIGN_TO_LITERAL,
+				node.offset,
+				{assign.target->offset, 0}});
+	}
+}
+
+/// @brief RULE: SemanticRule::DIVISION
+/// @param node: BinaryOpNode or a CommandNode with CommandRule::DIVISOR
+void SemanticAnalyzer::check_division(ASTNode &node)
 {
-	if (node.arguments.size() < 2)
+	if (node.Type == ASTNodeType::BINARY_OP)
+	{
+		const auto &binary = static_cast<const BinaryOpNode &>(node);
+
+		if (binary.op == '/')
+			check_division_by_zero(binary.right);
+
 		return;
+	}
+
+	const auto &command = static_cast<const CommandNode &>(node);
 
-	check_division_by_zero(node.arguments[1]);
+	if (command.arguments.size() >= 2)
+		check_division_by_zero(command.arguments[1]);
 }
 
-/// @brief Validate sqrt
-/// @param operand: Operand to check
-/// @param line: Line number
-/// @param column: Column number
-void SemanticAnalyzer::validate_sqrt(const ASTNode *operand, int line, int column)
+/// @brief RULE: SemanticRule::VARIABLES, reported by check_variables once every node is checked
+/// @param node: VariableNode or AssignNode
+void SemanticAnalyzer::record_variable(ASTNode &node)
 {
-	if (!operand)
+	if (node.Type == ASTNodeType::VARIABLE)
+	{
+		const auto &variable = static_cast<const VariableNode &>(node);
+		symbol_events.push_back({variable.symbol, variable.offset, false});
+		return;
+	}
+
+	const auto &assign = static_cast<const AssignNode &>(node);
+
+	if (assign.target && assign.target->Type == ASTNodeType::VARIABLE)
+	{
+		const auto *target = static_cast<const VariableNode *>(assign.target);
+		symbol_events.push_back({target->symbol, target->offset, true});
+	}
+}
+
+/// @brief Check division by 0
+/// @param denominator: Denominator
+void SemanticAnalyzer::check_division_by_zero(const ASTNode *denominator)
+{
+	double value;
+
+	if (constant_operand(denominator, value) && value == 0.0)
+	{
+		errors.push_back({DiagnosticCode::DIVISION_BY_ZERO,
+				denominator->offset,
+				{denominator->offset, 0}});
+	}
+}
+
+/// @brief RULE: SemanticRule::RADICAND
+/// @param node: CommandNode with CommandRule::RADICAND
+void SemanticAnalyzer::validate_root(ASTNode &node)
+{
+	const auto &command = static_cast<const CommandNode &>(node);
+
+	// The optional index comes first when present
+	size_t radicand_idx = command.arguments.size() == 2 ? 1 : 0;
+
+	if (radicand_idx < command.arguments.size())
+		validate_sqrt(command.arguments[radicand_idx], node.offset);
+}
+
+/// @brief RULE: SemanticRule::LOGARITHM
+/// @param node: CommandNode with CommandRule::LOGARITHM or a FunctionCallNode
+void SemanticAnalyzer::validate_logarithm(ASTNode &node)
+{
+	if (node.Type == ASTNodeType::FUNCTION_CALL)
+	{
+		// \log and \ln take no argument, \log{x} and \ln(x) are calls of the bare command
+		const auto &call = static_cast<const FunctionCallNode &>(node);
+
+		if (!call.function || call.function->Type != ASTNodeType::COMMAND || call.args.size() != 1)
+			return;
+
+		const auto *function = static_cast<const CommandNode *>(call.function);
+
+		if (function->arguments.empty() && function->id < CommandId::COUNT &&
+			COMMAND_RULES[static_cast<size_t>(function->id)] == CommandRule::LOGARITHM)
+			validate_log(call.args[0], function->offset);
+
+		return;
+	}
+
+	const auto &command = static_cast<const CommandNode &>(node);
+
+	if (!command.arguments.empty())
+		validate_log(command.arguments[0], node.offset);
+}
+
+/// @brief RULE: SemanticRule::INVERSE_TRIG
+/// @param node: CommandNode with CommandRule::INVERSE_TRIG
+void SemanticAnalyzer::validate_inverse_trig(ASTNode &node)
+{
+	const auto &command = static_cast<const CommandNode &>(node);
+	double value;
+
+	if (command.arguments.empty() || !constant_operand(command.arguments[0], value))
 		return;
 
-	if (operand->Type == ASTNodeType::NUMBER)
+	if (value < -1.0 || value > 1.0)
 	{
-		const auto *num = static_cast<const NumberNode *>(operand);
+		errors.push_back({DiagnosticCode::INVERSE_TRIG_DOMAIN,
+				node.offset,
+				{command.arguments[0]->offset, 0}});
+	}
+}
 
-		if (num->value < 0.0)
-		{
-			errors.push_back({"Square root of negative number (requires complex numbers)",
-					line,
-					column});
-		}
+/// @brief RULE: SemanticRule::RECIPROCAL_TRIG
+/// @param node: CommandNode with CommandRule::RECIPROCAL_TRIG
+void SemanticAnalyzer::validate_reciprocal_trig(ASTNode &node)
+{
+	const auto &command = static_cast<const CommandNode &>(node);
+	double value;
+
+	if (command.arguments.empty() || !constant_operand(command.arguments[0], value))
+		return;
+
+	if (value == 0.0)
+	{
+		errors.push_back({DiagnosticCode::TRIG_POLE,
+				node.offset,
+				{command.arguments[0]->offset, 0}});
 	}
+}
 
-	if (operand->Type == ASTNodeType::UNARY_OP)
+/// @brief RULE: SemanticRule::BINOMIAL
+/// @param node: CommandNode with CommandRule::BINOMIAL
+void SemanticAnalyzer::validate_binom(ASTNode &node)
+{
+	const auto &command = static_cast<const CommandNode &>(node);
+
+	for (const ASTNode *argument : command.arguments)
 	{
-		const auto *unary = static_cast<const UnaryOpNode *>(operand);
+		double value;
+
+		if (!constant_operand(argument, value))
+			continue;
 
-		if (unary->op == '-' && unary->operand->Type == ASTNodeType::NUMBER)
+		if (value < 0.0 || value != std::floor(value))
 		{
-			errors.push_back({"Square root of negative number (requires complex numbers)",
-					line,
-					column});
+			errors.push_back({DiagnosticCode::INVALID_BINOMIAL,
+					node.offset,
+					{argument->offset, 0}});
 		}
 	}
 }
 
+/// @brief Validate sqrt
+/// @param operand: Operand to check
+/// @param offset: Source byte offset
+void SemanticAnalyzer::validate_sqrt(const ASTNode *operand, uint32_t offset)
+{
+	double value;
+
+	if (constant_operand(operand, value) && value < 0.0)
+	{
+		errors.push_back({DiagnosticCode::SQRT_OF_NEGATIVE,
+				offset,
+				{operand->offset, 0}});
+	}
+}
+
 /// @brief Validate log
 /// @param operand: Operand to check
-/// @param line: Line number
-/// @param column: Column number
-void SemanticAnalyzer::validate_log(const ASTNode *operand, int line, int column)
+/// @param offset: Source byte offset
+void SemanticAnalyzer::validate_log(const ASTNode *operand, uint32_t offset)
 {
 	if (!operand)
 		return;
 
-	if (operand->Type == ASTNodeType::NUMBER)
-	{
-		const auto *num = static_cast<const NumberNode *>(operand);
+	double value;
 
-		if (num->value <= 0.0)
+	if (constant_operand(operand, value))
+	{
+		if (value <= 0.0)
 		{
-			errors.push_back({"Logarithm of non-positive number is undefined",
-					line,
-					column});
+			errors.push_back({value < 0.0 ? DiagnosticCode::LOG_OF_NEGATIVE : DiagnosticCode::LOG_OF_NON_POSITIVE,
+					offset,
+					{operand->offset, 0}});
 		}
+
+		return;
 	}
 
-	if (operand->Type == ASTNodeType::UNARY_OP)
+	// Not constant, a negated operand such as -x is still most likely negative
+	if (operand->Type == ASTNodeType::UNARY_OP && static_cast<const UnaryOpNode *>(operand)->op == '-')
 	{
-		const auto *unary = static_cast<const UnaryOpNode *>(operand);
-
-		if (unary->op == '-')
-		{
-			errors.push_back({"Logarithm of negative number is undefined",
-					line,
-					column});
-		}
+		errors.push_back({DiagnosticCode::LOG_OF_NEGATIVE,
+				offset,
+				{operand->offset, 0}});
 	}
 }
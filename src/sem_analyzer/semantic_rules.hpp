@@ -0,0 +1,84 @@
+#ifndef SEMANTIC_RULES_HPP
+#define SEMANTIC_RULES_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../ast/ast_info.hpp"
+
+// ======================
+// -- ENUMS / STRUCTS
+// ======================
+
+/// @brief A semantic check, enabled by its bit in a RuleSet
+/// @note Order must match SemanticAnalyzer::RULES, a new rule also needs its case in SemanticAnalyzer::run_rule
+enum class SemanticRule : uint8_t
+{
+	NUMBER_VALUE,    // INVALID_NUMBER_VALUE
+	ASSIGN_TARGET,   // ASSIGN_TO_LITERAL
+	DIVISION,        // DIVISION_BY_ZERO in '/' and \frac
+	RADICAND,        // SQRT_OF_NEGATIVE
+	LOGARITHM,       // LOG_OF_NON_POSITIVE, LOG_OF_NEGATIVE
+	INVERSE_TRIG,    // INVERSE_TRIG_DOMAIN
+	RECIPROCAL_TRIG, // TRIG_POLE
+	BINOMIAL,        // INVALID_BINOMIAL
+	VARIABLES,       // USE_BEFORE_DEFINITION, UNUSED_VARIABLE
+
+	COUNT
+};
+
+/// @brief Bit per SemanticRule
+using RuleSet = uint32_t;
+
+/// @brief Counters of one rule, see SemanticAnalyzer::rule_stats
+struct RuleStats
+{
+	uint64_t runs = 0;        // uint64_t: # of nodes the rule ran on
+	uint64_t reports = 0;     // uint64_t: # of diagnostics it reported
+	uint64_t nanoseconds = 0; // uint64_t: Time spent in the rule, only measured while profiling
+};
+
+static constexpr size_t AST_NODE_TYPE_COUNT = static_cast<size_t>(ASTNodeType::LEFT_RIGHT) + 1;
+
+// ======================
+// -- PUBLIC METHODS
+// ======================
+
+/// @brief Bit of a rule
+/// @param rule: The rule
+/// @return RuleSet
+constexpr RuleSet rule_bit(SemanticRule rule)
+{
+	return RuleSet{1} << static_cast<unsigned>(rule);
+}
+
+/// @brief Bit of a node type, for SemanticAnalyzer::RuleInfo::node_types
+/// @param type: The node type
+/// @return uint32_t
+constexpr uint32_t node_type_bit(ASTNodeType type)
+{
+	return uint32_t{1} << static_cast<unsigned>(type);
+}
+
+// ======================
+// -- PRESETS
+// ======================
+
+namespace RuleSets
+{
+	/// @brief Checks on the shape of the input alone
+	constexpr RuleSet SYNTAX = rule_bit(SemanticRule::NUMBER_VALUE) | rule_bit(SemanticRule::ASSIGN_TARGET);
+
+	/// @brief Checks that an operation is defined for its constant operands, see ConstantFolder
+	constexpr RuleSet MATH_DOMAIN = rule_bit(SemanticRule::DIVISION) | rule_bit(SemanticRule::RADICAND) |
+		rule_bit(SemanticRule::LOGARITHM) | rule_bit(SemanticRule::INVERSE_TRIG) |
+		rule_bit(SemanticRule::RECIPROCAL_TRIG) | rule_bit(SemanticRule::BINOMIAL);
+
+	/// @brief What SemanticAnalyzer runs unless told otherwise
+	constexpr RuleSet DEFAULT = SYNTAX | MATH_DOMAIN;
+
+	/// @brief Every rule, including the variable checks
+	constexpr RuleSet ALL = (RuleSet{1} << static_cast<unsigned>(SemanticRule::COUNT)) - 1;
+}
+
+#endif
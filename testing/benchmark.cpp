@@ -1,13 +1,974 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <new>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include <benchmark/benchmark.h>
 
 #include "../core/latex_core.hpp"
+#include "../core/latex_engine.hpp"
+#include "../core/latex_batch.hpp"
+#include "../core/latex_pipeline.hpp"
+#include "../ast/utility/ast_walker.hpp"
+#include "../ast/utility/constant_folder.hpp"
+#include "./heap_counter.hpp"
+
+// ======================
+// -- CORPUS
+// ======================
+
+/// @brief Build a multi-megabyte formula batch of short tokens
+/// @param bytes: Approximate size of the batch
+/// @return std::string
+static std::string make_formula_batch(size_t bytes) {
+	static const char *formulas[] = {
+		"\\frac{numerator}{denominator} + \\sqrt[3]{radicand} = 1234567.891011 \\\\\n",
+		"f(x, y) = alpha^{2} + beta_{10} - gamma \\cdot 3.14159265358979   % trailing comment\n",
+		"\\begin{matrix} 1 & 2 \\\\ 3 & 4 \\end{matrix}\t\t\n",
+		"\\left( variable + 42 \\right) \\leq \\sum_{i=0}^{n} i ! \n",
+		"% a long comment line explaining the next equation in some detail\n",
+		"                                                  x = 1000000000000000\n"};
+
+	std::string batch;
+	batch.reserve(bytes + 128);
+
+	for (size_t i = 0; batch.size() < bytes; i++)
+		batch += formulas[i % (sizeof(formulas) / sizeof(formulas[0]))];
+
+	return batch;
+}
+
+/// @brief Build a multi-megabyte batch of long whitespace, comment, identifier and digit runs
+/// @param bytes: Approximate size of the batch
+/// @return std::string
+static std::string make_sparse_batch(size_t bytes) {
+	std::string line = "% " + std::string(200, 'c') + "\n" + std::string(120, ' ') +
+		"x = " + std::string(100, 'a') + " + " + std::string(40, '7') + ".25\n";
+
+	std::string batch;
+	batch.reserve(bytes + line.size());
+
+	while (batch.size() < bytes)
+		batch += line;
+
+	return batch;
+}
+
+/// @brief Build a multi-megabyte batch that lexes, parses and analyzes without errors
+/// @param bytes: Approximate size of the batch
+/// @return std::string
+static std::string make_expression_batch(size_t bytes) {
+	static const char *formulas[] = {
+		"\\frac{a}{b} + \\sqrt[3]{x} = 1234.5 \\\\\n",
+		"f(x, y) = \\alpha^{2} + \\beta_{10} - x \\cdot 3.14   % comment\n",
+		"\\left( x + 42 \\right) \\leq \\sum_{i=0}^{n} i\n"};
+
+	std::string batch;
+	batch.reserve(bytes + 128);
+
+	for (size_t i = 0; batch.size() < bytes; i++)
+		batch += formulas[i % (sizeof(formulas) / sizeof(formulas[0]))];
+
+	return batch;
+}
+
+/// @brief Lines that each assign a new variable from the one before, e.g. "ab = aa + 1", every line interns a new name
+/// @param lines: # of lines
+/// @return std::string
+static std::string make_symbol_batch(size_t lines) {
+	std::string batch;
+
+	auto name = [](size_t index) {
+		std::string letters;
+
+		do {
+			letters += static_cast<char>('a' + index % 26);
+			index /= 26;
+		} while (index);
+
+		return letters;
+	};
+
+	for (size_t i = 1; i <= lines; i++)
+		batch += name(i) + " = " + name(i - 1) + " + 1 \\\\\n";
+
+	return batch;
+}
+
+/// @brief Short formulas that parse, one per node kind
+static const char *const SMALL_FORMULAS[] = {
+	"\\frac{a}{b} + \\sqrt[3]{x} = 1234.5",
+	"f(x, y, z) = \\alpha^{2} + \\beta_{10} - x \\cdot 3.14",
+	"\\left( x + 42 \\right) \\leq \\sum_{i=0}^{n} i",
+	"\\begin{matrix} 1 & 2 \\\\ 3 & 4 \\end{matrix}",
+	"g{x} + (a) [b] \\{c\\} \\\\ y = 2"};
+
+/// @brief Independent inputs of very uneven size: mostly short formulas, every 64th a long expression
+/// @param count: # of inputs
+/// @return std::vector<std::string>
+static std::vector<std::string> make_mixed_inputs(size_t count) {
+	std::vector<std::string> inputs;
+	inputs.reserve(count);
+
+	for (size_t i = 0; i < count; i++) {
+		std::string input = SMALL_FORMULAS[i % (sizeof(SMALL_FORMULAS) / sizeof(SMALL_FORMULAS[0]))];
+
+		if (i % 64 == 0) {
+			for (int j = 0; j < 2000; j++)
+				input += " + 2 * x_{1} - \\frac{y}{3}";
+		}
+
+		inputs.push_back(std::move(input));
+	}
+
+	return inputs;
+}
+
+/// @brief Short malformed inputs, one per parse error kind
+/// @return std::vector<std::string>
+static std::vector<std::string> make_malformed_inputs() {
+	return {
+		"\\frac{a}{b",
+		"x + (y * 2",
+		"a + b )",
+		"\\frac a b",
+		"x_{1}_{2} + y",
+		"\\left( x + 1",
+		"\\begin{matrix} 1 & 2 \\end{cases}",
+		"3 + * 4",
+		"f(x, y",
+		"\\sqrt[3{x}"};
+}
+
+// ======================
+// -- BENCHMARKS
+// ======================
 
 static void BM_LexerTokenization(benchmark::State &state, std::string equation) {
 	for (auto _ : state) {
 		LatexCore core_impl(equation);
-		benchmark::DoNotOptimize(core_impl);
+		benchmark::DoNotOptimize(core_impl.root);
+	}
+}
+
+/// @brief Full pipeline over a caller-owned buffer, reports heap bytes allocated per run
+/// @param borrowed: True to pass a std::string_view, false to hand LatexCore its own copy
+static void BM_CoreInput(benchmark::State &state, const std::string *batch, bool borrowed) {
+	size_t bytes_before = heap_bytes.load(std::memory_order_relaxed);
+
+	for (auto _ : state) {
+		if (borrowed) {
+			LatexCore core_impl{std::string_view(*batch)};
+			benchmark::DoNotOptimize(core_impl.return_errors().data());
+		} else {
+			LatexCore core_impl{std::string(*batch)};
+			benchmark::DoNotOptimize(core_impl.return_errors().data());
+		}
+	}
+
+	size_t bytes = heap_bytes.load(std::memory_order_relaxed) - bytes_before;
+	state.counters["heap_bytes"] = benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * batch->size());
+}
+
+/// @brief Full pipeline over a file, reports heap bytes allocated per run
+/// @param mapped: True to mmap the file, false to read it into a std::string first
+static void BM_CoreFile(benchmark::State &state, const std::string *path, bool mapped) {
+	size_t bytes_before = heap_bytes.load(std::memory_order_relaxed);
+	size_t file_size = std::filesystem::file_size(*path);
+
+	for (auto _ : state) {
+		if (mapped) {
+			LatexCore core_impl{MappedFile(*path)};
+			benchmark::DoNotOptimize(core_impl.return_errors().data());
+		} else {
+			std::ifstream file(*path, std::ios::binary);
+			std::string text{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+			LatexCore core_impl{std::move(text)};
+			benchmark::DoNotOptimize(core_impl.return_errors().data());
+		}
+	}
+
+	size_t bytes = heap_bytes.load(std::memory_order_relaxed) - bytes_before;
+	state.counters["heap_bytes"] = benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * file_size);
+}
+
+static void BM_LexerScan(benchmark::State &state, const std::string *batch, CharScan::Kernel kernel) {
+	size_t token_bytes = 0;
+	size_t token_count = 0;
+
+	for (auto _ : state) {
+		Lexer lexer(*batch, kernel);
+		auto tokens = lexer.tokenize();
+		benchmark::DoNotOptimize(tokens.types.data());
+
+		token_bytes = tokens.memory_usage();
+		token_count = tokens.size();
+	}
+
+	// Compare against sizeof(Token), what a std::vector<Token> would need per token
+	state.counters["bytes_per_token"] = static_cast<double>(token_bytes) / static_cast<double>(token_count);
+	state.counters["sizeof_token"] = static_cast<double>(sizeof(Token));
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * batch->size());
+}
+
+/// @brief The lexer's dispatch before CharClassTable: a std::function per byte value, built at static-init
+/// time and copied once per token, calling the same handlers Lexer::tokenize does
+class LexerReference
+{
+	private:
+		using LexerAction = std::function<void(Lexer *, TokenStream &)>;
+
+		static const std::array<LexerAction, 256> DISPATCH_TABLE;
+
+	public:
+		/// @brief Tokenize the lexer's input through DISPATCH_TABLE
+		/// @param lexer: The lexer, rewound
+		/// @param tokens: Stream to overwrite
+		static void tokenize(Lexer &lexer, TokenStream &tokens)
+		{
+			tokens.clear(lexer.input);
+			tokens.reserve(lexer.input.size() / 4);
+
+			while (lexer.position < lexer.input.size())
+			{
+				LexerAction action = DISPATCH_TABLE[static_cast<unsigned char>(lexer.input[lexer.position])];
+				action(&lexer, tokens);
+			}
+
+			tokens.push(lexer.position, 0, TokenType::END_OF_FILE, CommandId::NONE);
+		}
+};
+
+const std::array<LexerReference::LexerAction, 256> LexerReference::DISPATCH_TABLE = [] {
+	std::array<LexerAction, 256> table{};
+
+	for (int i = 0; i < 256; i++)
+		table[i] = [](Lexer *s, TokenStream &t) { s->handle_invalid(t); };
+
+	auto map_char = [&](unsigned char c, TokenType type) {
+		table[c] = [type](Lexer *self, TokenStream &tokens) { self->handle_single_char(tokens, type); };
+	};
+
+	auto num = [](Lexer *s, TokenStream &t) { s->handle_number(t); };
+	for (char c = '0'; c <= '9'; c++)
+		table[static_cast<unsigned char>(c)] = num;
+
+	auto ident = [](Lexer *s, TokenStream &t) { s->handle_identifier(t); };
+	for (char c = 'a'; c <= 'z'; c++)
+		table[static_cast<unsigned char>(c)] = ident;
+	for (char c = 'A'; c <= 'Z'; c++)
+		table[static_cast<unsigned char>(c)] = ident;
+
+	table[' '] = table['\t'] = table['\n'] = [](Lexer *s, TokenStream &t) { s->handle_whitespace(t); };
+	table['\\'] = [](Lexer *s, TokenStream &t) { s->handle_command(t); };
+	table['<'] = [](Lexer *s, TokenStream &t) { s->handle_less(t); };
+	table['>'] = [](Lexer *s, TokenStream &t) { s->handle_greater(t); };
+	table['%'] = [](Lexer *s, TokenStream &t) { s->handle_comment(t); };
+
+	map_char('{', TokenType::BRACE_OPEN);
+	map_char('}', TokenType::BRACE_CLOSE);
+	map_char('(', TokenType::PAREN_OPEN);
+	map_char(')', TokenType::PAREN_CLOSE);
+	map_char('[', TokenType::BRACKET_OPEN);
+	map_char(']', TokenType::BRACKET_CLOSE);
+	map_char('+', TokenType::PLUS);
+	map_char('-', TokenType::MINUS);
+	map_char('*', TokenType::STAR);
+	map_char('/', TokenType::SLASH);
+	map_char('^', TokenType::SUPERSCRIPT);
+	map_char('_', TokenType::SUBSCRIPT);
+	map_char('&', TokenType::ALIGNMENT);
+	map_char('$', TokenType::DOLLAR);
+	map_char('\'', TokenType::PUNCTUATION);
+	map_char('.', TokenType::PUNCTUATION);
+	map_char(':', TokenType::PUNCTUATION);
+	map_char(';', TokenType::PUNCTUATION);
+	map_char('?', TokenType::PUNCTUATION);
+	map_char(',', TokenType::SPACING);
+	map_char('=', TokenType::EQUAL);
+	map_char('!', TokenType::FACTORIAL);
+
+	return table;
+}();
+
+/// @brief Tokenize a batch through Lexer::tokenize or the std::function dispatch it replaced
+/// @param batch: The input
+/// @param function_table: True for LexerReference, false for Lexer::tokenize
+static void BM_LexerDispatch(benchmark::State &state, const std::string *batch, bool function_table) {
+	Lexer lexer(*batch);
+	TokenStream tokens, expected;
+	lexer.tokenize(expected);
+
+	// Both dispatches call the same handlers, a difference means the reference table went stale
+	lexer.reset(*batch);
+	LexerReference::tokenize(lexer, tokens);
+
+	if (tokens.types != expected.types || tokens.offsets != expected.offsets || tokens.lengths != expected.lengths) {
+		state.SkipWithError("The std::function dispatch tokenized differently");
+		return;
+	}
+
+	for (auto _ : state) {
+		lexer.reset(*batch);
+
+		if (function_table)
+			LexerReference::tokenize(lexer, tokens);
+		else
+			lexer.tokenize(tokens);
+
+		benchmark::DoNotOptimize(tokens.types.data());
+	}
+
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * batch->size());
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * tokens.size());
+}
+
+/// @brief Check if a node is a product, e.g. the x y of an implicit multiplication
+/// @param node: The node, may be nullptr
+/// @return True for a BinaryOpNode with '*'
+static bool is_product(const ASTNode *node) {
+	return node && node->Type == ASTNodeType::BINARY_OP && static_cast<const BinaryOpNode *>(node)->op == '*';
+}
+
+/// @brief Parse a long flat expression, reports per-token cost
+/// @param term: One term of the expression, repeated
+static void BM_ParseFlat(benchmark::State &state, const char *term) {
+	std::string input = "0";
+
+	for (int i = 0; i < 20000; i++)
+		input += term;
+
+	Lexer lexer(input);
+	TokenStream tokens = lexer.tokenize();
+
+	Parser checked(tokens);
+	ParseResult parsed = checked.try_parse();
+
+	if (!parsed.ok()) {
+		state.SkipWithError("The flat input did not parse");
+		return;
+	}
+
+	// An implicit product nests to the right, "x y z" is x * (y * z)
+	for (const ASTNode *node = parsed.root; is_product(node); node = static_cast<const BinaryOpNode *>(node)->right) {
+		if (is_product(static_cast<const BinaryOpNode *>(node)->left)) {
+			state.SkipWithError("The flat implicit product did not nest to the right");
+			return;
+		}
+	}
+
+	for (auto _ : state) {
+		Parser parser(tokens);
+		benchmark::DoNotOptimize(parser.parse());
+	}
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * tokens.size());
+}
+
+/// @brief One node of a tree in post-order, the sequence tells two trees apart
+struct NodeKey {
+	ASTNodeType type; // ASTNodeType: Node type
+	uint32_t offset;  // uint32_t: Source byte offset
+	uint64_t detail;  // uint64_t: Operator, value, symbol or # of children, by type
+
+	bool operator==(const NodeKey &other) const {
+		return type == other.type && offset == other.offset && detail == other.detail;
+	}
+};
+
+/// @brief Flatten a tree into NodeKeys
+/// @param root: Root of the tree, may be nullptr
+/// @return std::vector<NodeKey> in post-order
+static std::vector<NodeKey> tree_keys(ASTNode *root) {
+	std::vector<NodeKey> keys;
+	ASTWalker walker;
+
+	walker.post_order(root, [&keys](ASTNode &node) {
+		uint64_t detail = 0;
+
+		switch (node.Type) {
+			case ASTNodeType::NUMBER:
+				std::memcpy(&detail, &static_cast<const NumberNode &>(node).value, sizeof(double));
+				break;
+			case ASTNodeType::VARIABLE:
+				detail = static_cast<const VariableNode &>(node).symbol;
+				break;
+			case ASTNodeType::SYMBOL:
+				detail = std::hash<std::string_view>{}(static_cast<const SymbolNode &>(node).symbol);
+				break;
+			case ASTNodeType::GROUP:
+				detail = static_cast<const GroupNode &>(node).elements.size();
+				break;
+			case ASTNodeType::BINARY_OP:
+				detail = static_cast<unsigned char>(static_cast<const BinaryOpNode &>(node).op);
+				break;
+			case ASTNodeType::UNARY_OP:
+				detail = static_cast<unsigned char>(static_cast<const UnaryOpNode &>(node).op);
+				break;
+			case ASTNodeType::COMMAND: {
+				const auto &command = static_cast<const CommandNode &>(node);
+				detail = (static_cast<uint64_t>(command.id) << 32) | command.arguments.size();
+				break;
+			}
+			case ASTNodeType::SCRIPT: {
+				const auto &script = static_cast<const ScriptNode &>(node);
+				detail = (script.subscript ? 1 : 0) | (script.superscript ? 2 : 0);
+				break;
+			}
+			case ASTNodeType::FUNCTION_CALL:
+				detail = static_cast<const FunctionCallNode &>(node).args.size();
+				break;
+			case ASTNodeType::SEQUENCE:
+				detail = static_cast<const SequenceNode &>(node).elements.size();
+				break;
+			case ASTNodeType::ENVIRONMENT:
+				for (const NodeSpan &row : static_cast<const EnvironmentNode &>(node).content)
+					detail = detail * 31 + row.size() + 1;
+				break;
+			default:
+				break;
+		}
+
+		keys.push_back({node.Type, node.offset, detail});
+	});
+
+	return keys;
+}
+
+/// @brief Parse a large multi-line input, state.range(0) is the thread count
+/// @param parallel: True for Parser::parse_parallel(), false for Parser::parse()
+static void BM_ParseLines(benchmark::State &state, bool parallel) {
+	static const std::string input = make_expression_batch(1 << 20);
+	static const TokenStream tokens = Lexer(input).tokenize();
+
+	WorkStealingPool pool(static_cast<size_t>(state.range(0)));
+	Parser parser;
+
+	// The parallel parse must build the serial tree, with the same symbol ids and so the same diagnostics.
+	// Every line of the check input interns a new name, several workers and small slices finish out of
+	// source order even on one core
+	if (parallel) {
+		static const std::string check_input = make_symbol_batch(4000);
+		static const TokenStream check_tokens = Lexer(check_input).tokenize();
+
+		WorkStealingPool check_pool(4);
+		Parser serial(check_tokens);
+		ASTNode *expected = serial.parse();
+		SemanticAnalyzer analyzer(RuleSets::ALL);
+		analyzer.analyze(expected);
+		std::vector<SemanticError> expected_errors = analyzer.get_errors();
+
+		Parser split(check_tokens);
+		ASTNode *root = split.parse_parallel(check_pool, 64);
+		analyzer.analyze(root);
+
+		const std::vector<SemanticError> &errors = analyzer.get_errors();
+		bool same_errors = errors.size() == expected_errors.size() &&
+			std::equal(errors.begin(), errors.end(), expected_errors.begin(), [](const SemanticError &a, const SemanticError &b) {
+				return a.code == b.code && a.offset == b.offset && a.operands[0] == b.operands[0] && a.operands[1] == b.operands[1];
+			});
+
+		if (tree_keys(root) != tree_keys(expected) || !same_errors) {
+			state.SkipWithError("The parallel parse differs from the serial parse");
+			return;
+		}
+	}
+
+	for (auto _ : state) {
+		parser.reset(tokens);
+		benchmark::DoNotOptimize(parallel ? parser.parse_parallel(pool) : parser.parse());
+	}
+
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * tokens.size());
+}
+
+/// @brief Parse short formulas with one reset Parser, fails if Parser::parse() itself calls operator new
+static void BM_ParseHeap(benchmark::State &state) {
+	std::vector<TokenStream> streams;
+
+	for (const char *formula : SMALL_FORMULAS)
+		streams.push_back(Lexer(formula).tokenize());
+
+	// One pass grows the arena's chunks, the node stacks and the SymbolTable, later resets keep them
+	Parser parser;
+
+	for (const auto &tokens : streams) {
+		parser.reset(tokens);
+		parser.parse();
+	}
+
+	size_t allocations = 0;
+	size_t parses = 0;
+
+	for (auto _ : state) {
+		for (const auto &tokens : streams) {
+			parser.reset(tokens);
+
+			size_t before = heap_allocations.load(std::memory_order_relaxed);
+			benchmark::DoNotOptimize(parser.parse());
+			allocations += heap_allocations.load(std::memory_order_relaxed) - before;
+			parses++;
+		}
+	}
+
+	state.counters["allocations_per_parse"] = static_cast<double>(allocations) / static_cast<double>(parses);
+	state.SetItemsProcessed(static_cast<int64_t>(parses));
+
+	if (allocations > 0)
+		state.SkipWithError("Parser::parse() allocated from the heap after warming up");
+}
+
+/// @brief Arena lifetimes of a service parsing many small formulas
+enum class ArenaChurn { UNPOOLED, POOLED, RESET };
+
+/// @brief Allocate a small AST's worth of nodes per iteration, reports heap allocations per iteration
+/// @param mode: UNPOOLED and POOLED build a fresh arena each time (ChunkPool off / on), RESET reuses one arena
+static void BM_ArenaChurn(benchmark::State &state, ArenaChurn mode) {
+	ChunkPool::instance().set_capacity(mode == ArenaChurn::UNPOOLED ? 0 : ChunkPool::DEFAULT_CAPACITY);
+
+	ASTArena reused;
+	size_t allocations_before = heap_allocations.load(std::memory_order_relaxed);
+
+	auto fill = [](ASTArena &arena) {
+		for (int i = 0; i < 200; i++)
+			benchmark::DoNotOptimize(make_node<NumberNode>(arena, 1.0, static_cast<uint32_t>(i)));
+	};
+
+	for (auto _ : state) {
+		if (mode == ArenaChurn::RESET) {
+			fill(reused);
+			reused.reset();
+		} else {
+			ASTArena arena;
+			fill(arena);
+		}
+	}
+
+	size_t allocations = heap_allocations.load(std::memory_order_relaxed) - allocations_before;
+	state.counters["allocations"] = benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+	state.counters["high_water"] = static_cast<double>(reused.stats().high_water);
+
+	ChunkPool::instance().set_capacity(ChunkPool::DEFAULT_CAPACITY);
+}
+
+/// @brief Lex, parse and analyze short formulas, reports heap allocations per formula
+/// @param reuse: True for one LatexEngine across calls, false for a LatexCore per formula
+static void BM_Engine(benchmark::State &state, bool reuse) {
+	LatexEngine engine;
+	size_t allocations = 0;
+	size_t formulas = 0;
+
+	for (auto _ : state) {
+		for (const char *formula : SMALL_FORMULAS) {
+			size_t before = heap_allocations.load(std::memory_order_relaxed);
+
+			if (reuse) {
+				LatexView view = engine.process(formula);
+				benchmark::DoNotOptimize(view.root);
+			} else {
+				LatexCore core_impl{std::string_view(formula)};
+				benchmark::DoNotOptimize(core_impl.root);
+			}
+
+			allocations += heap_allocations.load(std::memory_order_relaxed) - before;
+			formulas++;
+		}
+	}
+
+	state.counters["allocations_per_formula"] = static_cast<double>(allocations) / static_cast<double>(formulas);
+	state.SetItemsProcessed(static_cast<int64_t>(formulas));
+}
+
+/// @brief Check a formula batch with the tree-building or the fused single-pass path, reports peak arena bytes
+/// @param fused: True for LatexEngine::validate, false for LatexEngine::process
+static void BM_Validate(benchmark::State &state, bool fused) {
+	static const std::string batch = make_formula_batch(4 * 1024 * 1024);
+
+	LatexEngine engine;
+	size_t arena_bytes = 0;
+
+	for (auto _ : state) {
+		LatexView view = fused ? engine.validate(batch) : engine.process(batch);
+		benchmark::DoNotOptimize(view.errors);
+		arena_bytes = engine.arena_stats().high_water;
+	}
+
+	state.counters["arena_bytes"] = static_cast<double>(arena_bytes);
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(batch.size()));
+}
+
+/// @brief Process a mixed-size batch on LatexBatch, state.range(0) is the thread count
+/// @param chunk_size: Inputs a worker claims at a time
+static void BM_Batch(benchmark::State &state, size_t chunk_size) {
+	static const std::vector<std::string> inputs = make_mixed_inputs(4096);
+	static const std::vector<std::string_view> views(inputs.begin(), inputs.end());
+
+	size_t bytes = 0;
+
+	for (const auto &input : inputs)
+		bytes += input.size();
+
+	LatexBatch batch({static_cast<size_t>(state.range(0)), chunk_size});
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(batch.process_batch(views));
+
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(bytes));
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(inputs.size()));
+}
+
+/// @brief Stream a mixed-size batch through LatexPipeline or LatexCore, reports the time to the first result
+/// @param pipelined: True for LatexPipeline, false for a run-to-completion LatexCore per input
+static void BM_Pipeline(benchmark::State &state, bool pipelined) {
+	static const std::vector<std::string> inputs = make_mixed_inputs(4096);
+	static const std::vector<std::string_view> views(inputs.begin(), inputs.end());
+
+	size_t bytes = 0;
+
+	for (const auto &input : inputs)
+		bytes += input.size();
+
+	LatexPipeline pipeline;
+	double first_result = 0.0;
+
+	for (auto _ : state) {
+		auto start = std::chrono::steady_clock::now();
+		bool first = true;
+
+		auto record = [&]() {
+			if (first) {
+				first_result += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+				first = false;
+			}
+		};
+
+		if (pipelined) {
+			pipeline.process_stream(views.data(), views.size(), [&](size_t, const LatexView &view) {
+				benchmark::DoNotOptimize(view.root);
+				record();
+			});
+		} else {
+			for (std::string_view view : views) {
+				LatexCore core_impl{view};
+				benchmark::DoNotOptimize(core_impl.root);
+				record();
+			}
+		}
+	}
+
+	state.counters["first_result_us"] = benchmark::Counter(first_result, benchmark::Counter::kAvgIterations);
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(bytes));
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(inputs.size()));
+}
+
+/// @brief Lex and parse malformed inputs
+/// @param throwing: True for Parser::parse (throws ParseError), false for Parser::try_parse
+static void BM_ParseMalformed(benchmark::State &state, bool throwing) {
+	static const std::vector<std::string> inputs = make_malformed_inputs();
+	static const std::vector<TokenStream> streams = [] {
+		std::vector<TokenStream> s;
+
+		for (const auto &input : inputs)
+			s.push_back(Lexer(input).tokenize());
+
+		return s;
+	}();
+
+	size_t failures = 0;
+
+	for (auto _ : state) {
+		for (const auto &tokens : streams) {
+			Parser parser(tokens);
+
+			if (throwing) {
+				try {
+					benchmark::DoNotOptimize(parser.parse());
+				} catch (const ParseError &e) {
+					benchmark::DoNotOptimize(e.what());
+					failures++;
+				}
+			} else {
+				ParseResult result = parser.try_parse();
+				benchmark::DoNotOptimize(result);
+				failures += !result.ok();
+			}
+		}
 	}
+
+	if (failures != static_cast<size_t>(state.iterations()) * streams.size())
+		state.SkipWithError("An input parsed successfully");
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * streams.size());
+}
+
+/// @brief Semantic analysis of an input where every line has errors, reports heap bytes per run
+static void BM_AnalyzeDiagnostics(benchmark::State &state) {
+	static const std::string input = [] {
+		std::string text;
+
+		for (int i = 0; i < 1000; i++)
+			text += "\\frac{1}{0} + \\sqrt{-4} + \\log{0} + x / 0\n";
+
+		return text;
+	}();
+
+	Lexer lexer(input);
+	TokenStream tokens = lexer.tokenize();
+	Parser parser(tokens);
+	ASTNode *root = parser.parse();
+	SemanticAnalyzer analyzer;
+
+	size_t bytes_before = heap_bytes.load(std::memory_order_relaxed);
+
+	for (auto _ : state) {
+		analyzer.analyze(root);
+		benchmark::DoNotOptimize(analyzer.error_counts());
+	}
+
+	size_t bytes = heap_bytes.load(std::memory_order_relaxed) - bytes_before;
+	state.counters["heap_bytes"] = benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+	state.counters["errors"] = static_cast<double>(analyzer.get_errors().size());
+}
+
+/// @brief Analyze the AST of a multi-megabyte batch, reports nodes per second
+/// @param rules: Semantic rules to run
+static void BM_AnalyzeTree(benchmark::State &state, RuleSet rules) {
+	static const std::string input = make_expression_batch(4 << 20);
+	static const TokenStream tokens = Lexer(input).tokenize();
+
+	Parser parser(tokens);
+	ASTNode *root = parser.parse();
+	SemanticAnalyzer analyzer(rules);
+
+	size_t nodes = 0;
+	ASTWalker walker;
+	walker.post_order(root, [&nodes](ASTNode &) { nodes++; });
+
+	for (auto _ : state) {
+		analyzer.analyze(root);
+		benchmark::DoNotOptimize(analyzer.get_errors().data());
+	}
+
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(nodes));
+}
+
+/// @brief Formulas whose error only shows once a constant subtree is folded, and the error each must report
+static const std::pair<const char *, DiagnosticCode> FOLDED_ERRORS[] = {
+	{"\\frac{1}{\\sqrt{0}}", DiagnosticCode::DIVISION_BY_ZERO},
+	{"\\frac{1}{\\sqrt[3]{0}}", DiagnosticCode::DIVISION_BY_ZERO},
+	{"\\sqrt{\\sqrt{4}-3}", DiagnosticCode::SQRT_OF_NEGATIVE},
+	{"\\log{\\sqrt{4}-3}", DiagnosticCode::LOG_OF_NEGATIVE},
+	{"\\arcsin{\\sqrt{9}}", DiagnosticCode::INVERSE_TRIG_DOMAIN},
+	{"\\frac{1}{\\binom{4}{2}-6}", DiagnosticCode::DIVISION_BY_ZERO},
+};
+
+/// @brief Fold the AST of a multi-megabyte batch without analyzing it, reports nodes per second
+static void BM_FoldTree(benchmark::State &state) {
+	static const std::string input = make_expression_batch(4 << 20);
+	static const TokenStream tokens = Lexer(input).tokenize();
+
+	LatexEngine engine;
+
+	for (const auto &[formula, code] : FOLDED_ERRORS) {
+		LatexView view = engine.process(formula);
+
+		if (view.errors->size() != 1 || view.errors->front().code != code) {
+			state.SkipWithError((std::string("Folding missed the error of ") + formula).c_str());
+			return;
+		}
+	}
+
+	Parser parser(tokens);
+	ASTNode *root = parser.parse();
+	ConstantFolder folder;
+
+	for (auto _ : state) {
+		folder.fold_tree(root);
+		benchmark::ClobberMemory();
+	}
+
+	size_t nodes = 0, constants = 0;
+	ASTWalker walker;
+	walker.post_order(root, [&](ASTNode &node) {
+		nodes++;
+		constants += node.fold == FoldState::CONSTANT;
+	});
+
+	state.counters["constant_nodes"] = static_cast<double>(constants);
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(nodes));
+}
+
+/// @brief Analyze the AST of a batch made mostly of commands with semantic rules, reports commands per second
+static void BM_AnalyzeCommands(benchmark::State &state) {
+	static const char *formulas[] = {
+		"\\frac{1}{x} + \\sqrt{2} \\cdot \\binom{n}{2} - \\arcsin{0.5} + \\cot{y} \\\\\n",
+		"\\alpha \\cdot \\frac{\\sqrt[3]{a}}{\\binom{4}{k}} + \\arccos{x} \\times \\csc{1} \\\\\n"};
+
+	static const std::string input = [] {
+		std::string batch;
+
+		for (size_t i = 0; batch.size() < (size_t{4} << 20); i++)
+			batch += formulas[i % 2];
+
+		return batch;
+	}();
+	static const TokenStream tokens = Lexer(input).tokenize();
+
+	Parser parser(tokens);
+	ASTNode *root = parser.parse();
+	SemanticAnalyzer analyzer;
+
+	size_t commands = 0;
+	ASTWalker walker;
+	walker.post_order(root, [&commands](ASTNode &node) { commands += node.Type == ASTNodeType::COMMAND; });
+
+	for (auto _ : state) {
+		analyzer.analyze(root);
+		benchmark::DoNotOptimize(analyzer.get_errors().data());
+	}
+
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size()));
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(commands));
+}
+
+/// @brief Counts nodes through the virtual ASTVisitor interface
+class CountingVisitor : public ASTVisitor
+{
+	public:
+		size_t counts[13] = {};
+
+		void visit(NumberNode &) override { counts[0]++; }
+		void visit(VariableNode &) override { counts[1]++; }
+		void visit(SymbolNode &) override { counts[2]++; }
+		void visit(AssignNode &) override { counts[3]++; }
+		void visit(GroupNode &) override { counts[4]++; }
+		void visit(BinaryOpNode &) override { counts[5]++; }
+		void visit(UnaryOpNode &) override { counts[6]++; }
+		void visit(CommandNode &) override { counts[7]++; }
+		void visit(ScriptNode &) override { counts[8]++; }
+		void visit(FunctionCallNode &) override { counts[9]++; }
+		void visit(SequenceNode &) override { counts[10]++; }
+		void visit(EnvironmentNode &) override { counts[11]++; }
+		void visit(LeftRightNode &) override { counts[12]++; }
+};
+
+/// @brief Walk a large AST with a per-class counter, through ASTVisitor or dispatched on ASTNodeType
+/// @param dynamic: True for the virtual ASTVisitor, false for NodeOverloads
+static void BM_Walk(benchmark::State &state, bool dynamic) {
+	static const std::string input = make_expression_batch(4 << 20);
+	static const TokenStream tokens = Lexer(input).tokenize();
+
+	Parser parser(tokens);
+	ASTNode *root = parser.parse();
+	ASTWalker walker;
+	CountingVisitor visitor;
+	size_t *counts = visitor.counts;
+
+	auto count_static = NodeOverloads{
+		[counts](NumberNode &) { counts[0]++; },
+		[counts](VariableNode &) { counts[1]++; },
+		[counts](BinaryOpNode &) { counts[5]++; },
+		[counts](CommandNode &) { counts[7]++; },
+		[counts](ASTNode &node) { counts[static_cast<size_t>(node.Type)]++; }};
+
+	for (auto _ : state) {
+		if (dynamic)
+			walker.post_order(root, visitor);
+		else
+			walker.post_order(root, count_static);
+
+		benchmark::DoNotOptimize(counts);
+	}
+
+	size_t nodes = 0;
+
+	for (size_t count : visitor.counts)
+		nodes += count;
+
+	state.SetItemsProcessed(static_cast<int64_t>(nodes));
+}
+
+/// @brief First lookup in a SourceMap, which collects every newline offset
+static void BM_SourceMapBuild(benchmark::State &state, const std::string *batch) {
+	for (auto _ : state) {
+		SourceMap map(*batch);
+		benchmark::DoNotOptimize(map.locate(batch->size() - 1));
+	}
+
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * batch->size());
+}
+
+/// @brief Command names that all hit, or all miss, the registry
+/// @param hits: True for registered names
+/// @return std::vector<std::string>
+static std::vector<std::string> make_command_names(bool hits) {
+	std::vector<std::string> names;
+
+	for (size_t i = 0; i < LatexParser::LATEX_COMMANDS.count; i++) {
+		std::string name(LatexParser::LATEX_COMMANDS.entries[i].name);
+
+		if (!hits)
+			name += "q";
+
+		names.push_back(std::move(name));
+	}
+
+	return names;
+}
+
+static void BM_FindCommand(benchmark::State &state, bool hits) {
+	static const std::vector<std::string> hit_names = make_command_names(true);
+	static const std::vector<std::string> miss_names = make_command_names(false);
+	const auto &names = hits ? hit_names : miss_names;
+
+	for (auto _ : state) {
+		for (const auto &name : names)
+			benchmark::DoNotOptimize(LatexParser::find_command(name));
+	}
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * names.size());
+}
+
+/// @brief Lookup through the std::unordered_map registry used before the perfect hash
+static void BM_FindCommandUnorderedMap(benchmark::State &state, bool hits) {
+	static const std::unordered_map<std::string_view, CommandInfo> map = [] {
+		std::unordered_map<std::string_view, CommandInfo> m;
+
+		for (size_t i = 0; i < LatexParser::LATEX_COMMANDS.count; i++)
+			m.emplace(LatexParser::LATEX_COMMANDS.entries[i].name, LatexParser::LATEX_COMMANDS.entries[i].info);
+
+		return m;
+	}();
+
+	static const std::vector<std::string> hit_names = make_command_names(true);
+	static const std::vector<std::string> miss_names = make_command_names(false);
+	const auto &names = hits ? hit_names : miss_names;
+
+	for (auto _ : state) {
+		for (const auto &name : names) {
+			auto it = map.find(name);
+			benchmark::DoNotOptimize(it != map.end() ? &it->second : nullptr);
+		}
+	}
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * names.size());
 }
 
 int main(int argc, char** argv) {
@@ -16,11 +977,93 @@ int main(int argc, char** argv) {
 	if (argc > 1) {
 		std::string eq = argv[1];
 		benchmark::RegisterBenchmark("BM_LexerTokenization", BM_LexerTokenization, eq);
-	} else {
-		std::cerr << "Usage: " << argv[0] << " <equation_string>\n";
-		return 1;
 	}
 
+	static const std::string dense = make_formula_batch(4 << 20);
+	static const std::string sparse = make_sparse_batch(4 << 20);
+
+	for (auto [batch, batch_name] : {std::pair{&dense, "dense"}, std::pair{&sparse, "sparse"}}) {
+		for (auto [kernel, kernel_name] : {std::pair{CharScan::Kernel::SCALAR, "scalar"},
+				std::pair{CharScan::Kernel::SSE2, "sse2"},
+				std::pair{CharScan::Kernel::AVX2, "avx2"},
+				std::pair{CharScan::Kernel::AVX512, "avx512"}}) {
+			if (!CharScan::is_supported(kernel))
+				continue;
+
+			std::string name = std::string("BM_LexerScan/") + batch_name + "/" + kernel_name;
+			benchmark::RegisterBenchmark(name.c_str(), BM_LexerScan, batch, kernel);
+		}
+	}
+
+	for (auto [batch, batch_name] : {std::pair{&dense, "dense"}, std::pair{&sparse, "sparse"}}) {
+		benchmark::RegisterBenchmark((std::string("BM_LexerDispatch/function_table/") + batch_name).c_str(), BM_LexerDispatch, batch, true);
+		benchmark::RegisterBenchmark((std::string("BM_LexerDispatch/class_table/") + batch_name).c_str(), BM_LexerDispatch, batch, false);
+	}
+
+	static const std::string expressions = make_expression_batch(4 << 20);
+
+	benchmark::RegisterBenchmark("BM_CoreInput/owned_copy", BM_CoreInput, &expressions, false);
+	benchmark::RegisterBenchmark("BM_CoreInput/borrowed_view", BM_CoreInput, &expressions, true);
+
+	static const std::string expressions_path = (std::filesystem::temp_directory_path() / "latex_bench_expressions.tex").string();
+	std::ofstream(expressions_path, std::ios::binary) << expressions;
+
+	benchmark::RegisterBenchmark("BM_CoreFile/read_string", BM_CoreFile, &expressions_path, false);
+	benchmark::RegisterBenchmark("BM_CoreFile/mmap", BM_CoreFile, &expressions_path, true);
+
+	benchmark::RegisterBenchmark("BM_ParseFlat/numbers", BM_ParseFlat, " + 1");
+	benchmark::RegisterBenchmark("BM_ParseFlat/mixed", BM_ParseFlat, " + 2 * x - y / 3 < 4");
+	benchmark::RegisterBenchmark("BM_ParseFlat/power", BM_ParseFlat, " + x^2^3");
+	benchmark::RegisterBenchmark("BM_ParseFlat/assign_chain", BM_ParseFlat, " = x");
+	benchmark::RegisterBenchmark("BM_ParseFlat/implicit_mul", BM_ParseFlat, " x");
+	benchmark::RegisterBenchmark("BM_ParseFlat/implicit_mul_spaced", BM_ParseFlat, " \\, x");
+
+	benchmark::RegisterBenchmark("BM_ParsePrimary/atoms", BM_ParseFlat, " + x y 2 z");
+	benchmark::RegisterBenchmark("BM_ParsePrimary/groups", BM_ParseFlat, " + (x) \\{y\\} [z]");
+	benchmark::RegisterBenchmark("BM_ParsePrimary/commands", BM_ParseFlat, " + \\alpha \\beta , \\gamma");
+
+	int max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	benchmark::RegisterBenchmark("BM_ParseLines/serial", BM_ParseLines, false)->Arg(1)->UseRealTime();
+	benchmark::RegisterBenchmark("BM_ParseLines/parallel", BM_ParseLines, true)->RangeMultiplier(2)->Range(1, max_threads)->UseRealTime();
+
+	benchmark::RegisterBenchmark("BM_ParseHeap", BM_ParseHeap);
+
+	benchmark::RegisterBenchmark("BM_Engine/latex_core", BM_Engine, false);
+	benchmark::RegisterBenchmark("BM_Engine/reused", BM_Engine, true);
+
+	benchmark::RegisterBenchmark("BM_Validate/process", BM_Validate, false);
+	benchmark::RegisterBenchmark("BM_Validate/fused", BM_Validate, true);
+
+	benchmark::RegisterBenchmark("BM_Batch/chunk_16", BM_Batch, size_t{16})->RangeMultiplier(2)->Range(1, max_threads)->UseRealTime();
+	benchmark::RegisterBenchmark("BM_Batch/chunk_1", BM_Batch, size_t{1})->Arg(max_threads)->UseRealTime();
+
+	benchmark::RegisterBenchmark("BM_Pipeline/run_to_completion", BM_Pipeline, false)->UseRealTime();
+	benchmark::RegisterBenchmark("BM_Pipeline/pipelined", BM_Pipeline, true)->UseRealTime();
+
+	benchmark::RegisterBenchmark("BM_ArenaChurn/unpooled", BM_ArenaChurn, ArenaChurn::UNPOOLED);
+	benchmark::RegisterBenchmark("BM_ArenaChurn/pooled", BM_ArenaChurn, ArenaChurn::POOLED);
+	benchmark::RegisterBenchmark("BM_ArenaChurn/reset", BM_ArenaChurn, ArenaChurn::RESET);
+
+	benchmark::RegisterBenchmark("BM_ParseMalformed/throwing", BM_ParseMalformed, true);
+	benchmark::RegisterBenchmark("BM_ParseMalformed/result", BM_ParseMalformed, false);
+
+	benchmark::RegisterBenchmark("BM_AnalyzeDiagnostics", BM_AnalyzeDiagnostics);
+	benchmark::RegisterBenchmark("BM_AnalyzeTree", BM_AnalyzeTree, RuleSets::DEFAULT);
+	benchmark::RegisterBenchmark("BM_AnalyzeTree/syntax", BM_AnalyzeTree, RuleSets::SYNTAX);
+	benchmark::RegisterBenchmark("BM_AnalyzeTree/all", BM_AnalyzeTree, RuleSets::ALL);
+	benchmark::RegisterBenchmark("BM_AnalyzeCommands", BM_AnalyzeCommands);
+	benchmark::RegisterBenchmark("BM_FoldTree", BM_FoldTree);
+	benchmark::RegisterBenchmark("BM_Walk/ast_visitor", BM_Walk, true);
+	benchmark::RegisterBenchmark("BM_Walk/static", BM_Walk, false);
+
+	benchmark::RegisterBenchmark("BM_SourceMapBuild/dense", BM_SourceMapBuild, &dense);
+
+	benchmark::RegisterBenchmark("BM_FindCommand/perfect_hash/hit", BM_FindCommand, true);
+	benchmark::RegisterBenchmark("BM_FindCommand/perfect_hash/miss", BM_FindCommand, false);
+	benchmark::RegisterBenchmark("BM_FindCommand/unordered_map/hit", BM_FindCommandUnorderedMap, true);
+	benchmark::RegisterBenchmark("BM_FindCommand/unordered_map/miss", BM_FindCommandUnorderedMap, false);
+
 	benchmark::RunSpecifiedBenchmarks();
+	std::filesystem::remove(expressions_path);
 	return 0;
 }
@@ -0,0 +1,32 @@
+#include <cstdlib>
+#include <new>
+
+#include "./heap_counter.hpp"
+
+// ======================
+// -- ALLOCATION COUNTER
+// ======================
+
+// Kept out of benchmark.cpp, GCC inlines the replaced operator delete there and then warns that free
+// is called on a pointer returned by new (-Wmismatched-new-delete)
+
+std::atomic<size_t> heap_bytes{0};
+std::atomic<size_t> heap_allocations{0};
+
+void *operator new(size_t size) {
+	heap_bytes.fetch_add(size, std::memory_order_relaxed);
+	heap_allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void *ptr = std::malloc(size ? size : 1))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+	std::free(ptr);
+}
@@ -0,0 +1,17 @@
+#ifndef HEAP_COUNTER_HPP
+#define HEAP_COUNTER_HPP
+
+#include <atomic>
+#include <cstddef>
+
+// ======================
+// -- ALLOCATION COUNTER
+// ======================
+
+/// @brief Bytes requested from the replaced global operator new since start
+extern std::atomic<size_t> heap_bytes;
+
+/// @brief Calls of the replaced global operator new since start
+extern std::atomic<size_t> heap_allocations;
+
+#endif